@@ -93,10 +93,21 @@ public class ManifestManager
     public readonly RestClient Client = new RestClient();
 
     public async Task<Manifest> GetManifest(string url)
+    {
+        return ReadManifest(await DownloadManifest(url));
+    }
+
+    // Raw manifest bytes, so they can be cached in the mount index
+    public async Task<byte[]?> DownloadManifest(string url)
     {
         RestResponse Response = await Client.ExecuteAsync(new RestRequest(url));
 
-        return new Manifest(Response.RawBytes, new ManifestOptions
+        return Response.RawBytes;
+    }
+
+    public Manifest ReadManifest(byte[] Data)
+    {
+        return new Manifest(Data, new ManifestOptions
         {
             ChunkBaseUri = new Uri("https://epicgames-download1.akamaized.net/Builds/Fortnite/Content/CloudDir/ChunksV4/", UriKind.Absolute),
             ChunkCacheDirectory = new DirectoryInfo(Globals.ExportDirectory + "/Chunks")
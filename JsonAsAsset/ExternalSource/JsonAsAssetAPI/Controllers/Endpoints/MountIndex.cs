@@ -0,0 +1,143 @@
+using System.Security.Cryptography;
+using System.Text;
+using Newtonsoft.Json;
+
+using J = Newtonsoft.Json.JsonPropertyAttribute;
+
+namespace JsonAsAssetAPI.Endpoints.ContentManager;
+
+// Persisted mount index, stored next to the project config so warm starts
+// can skip work that only depends on the archives on disk and the settings.
+public class MountIndex
+{
+    // Hash of every archive (name, size, timestamp) and the settings used to mount them
+    [J] public string Fingerprint = "";
+
+    // Key guids that mounted at least one archive last launch
+    [J] public List<string> MountedKeyGuids = new List<string>();
+
+    // Content build label + cached manifest (relative to the index folder)
+    [J] public string ManifestLabel = "";
+    [J] public string ManifestFile = "";
+
+    [JsonIgnore] public string IndexFolder = "";
+    [JsonIgnore] public bool bIsWarm;
+
+    private const string IndexFileName = "MountIndex.json";
+
+    public static string ComputeFingerprint(string ArchiveDirectory, string BuildInfo, params string?[] Settings)
+    {
+        StringBuilder Builder = new StringBuilder();
+
+        foreach (string Setting in Settings)
+            Builder.Append(Setting).Append('\n');
+
+        // Archive table, any change here invalidates the index
+        DirectoryInfo Archives = new DirectoryInfo(ArchiveDirectory);
+        if (Archives.Exists)
+        {
+            foreach (FileInfo Archive in Archives.EnumerateFiles("*", SearchOption.TopDirectoryOnly).OrderBy(x => x.Name, StringComparer.OrdinalIgnoreCase))
+                Builder.Append(Archive.Name).Append('|').Append(Archive.Length).Append('|').Append(Archive.LastWriteTimeUtc.Ticks).Append('\n');
+        }
+
+        // Content build label lives in BuildInfo.ini
+        if (BuildInfo != "" && File.Exists(BuildInfo))
+            Builder.Append(File.GetLastWriteTimeUtc(BuildInfo).Ticks).Append('\n');
+
+        return Convert.ToHexString(SHA256.HashData(Encoding.UTF8.GetBytes(Builder.ToString())));
+    }
+
+    // Loads the index in IndexFolder, returns a cold (empty) index if it is missing or stale
+    public static MountIndex Load(string IndexFolder, string Fingerprint)
+    {
+        MountIndex? Index = null;
+        string IndexPath = Path.Combine(IndexFolder, IndexFileName);
+
+        try
+        {
+            if (File.Exists(IndexPath))
+                Index = JsonConvert.DeserializeObject<MountIndex>(File.ReadAllText(IndexPath));
+        }
+        catch (Exception e)
+        {
+            LogFailure($"Failed to read {IndexPath}, cold starting", e);
+            Index = null;
+        }
+
+        if (Index == null || Index.Fingerprint != Fingerprint)
+            Index = new MountIndex { Fingerprint = Fingerprint };
+        else
+            Index.bIsWarm = true;
+
+        Index.IndexFolder = IndexFolder;
+        return Index;
+    }
+
+    public void Save()
+    {
+        try
+        {
+            Directory.CreateDirectory(IndexFolder);
+            File.WriteAllText(Path.Combine(IndexFolder, IndexFileName), JsonConvert.SerializeObject(this, Formatting.Indented));
+        }
+        catch (Exception e)
+        {
+            // Not fatal, next launch will just be a cold start
+            LogFailure($"Failed to save {Path.Combine(IndexFolder, IndexFileName)}", e);
+        }
+    }
+
+    // Only keys that mounted something last time need to be submitted on a warm start
+    public bool ShouldSubmitKey(string Guid)
+    {
+        return !bIsWarm || MountedKeyGuids.Contains(Guid, StringComparer.OrdinalIgnoreCase);
+    }
+
+    public void RecordKey(string Guid, int MountedCount)
+    {
+        if (MountedCount > 0 && !MountedKeyGuids.Contains(Guid, StringComparer.OrdinalIgnoreCase))
+            MountedKeyGuids.Add(Guid);
+    }
+
+    public byte[]? LoadManifest(string Label)
+    {
+        if (!bIsWarm || ManifestLabel != Label || ManifestFile == "")
+            return null;
+
+        string ManifestPath = Path.Combine(IndexFolder, ManifestFile);
+
+        try
+        {
+            return File.Exists(ManifestPath) ? File.ReadAllBytes(ManifestPath) : null;
+        }
+        catch (Exception e)
+        {
+            LogFailure($"Failed to read {ManifestPath}, downloading it again", e);
+            return null;
+        }
+    }
+
+    public void StoreManifest(string Label, byte[] Data)
+    {
+        try
+        {
+            Directory.CreateDirectory(IndexFolder);
+            ManifestFile = "ContentBuild.manifest";
+            File.WriteAllBytes(Path.Combine(IndexFolder, ManifestFile), Data);
+            ManifestLabel = Label;
+        }
+        catch (Exception e)
+        {
+            LogFailure("Failed to cache the content build manifest", e);
+            ManifestFile = "";
+        }
+    }
+
+    private static void LogFailure(string Description, Exception e)
+    {
+        Console.ForegroundColor = ConsoleColor.Yellow;
+        Console.Write("[MountIndex] ");
+        Console.ResetColor();
+        Console.Write($"{Description}: {e.Message}\n");
+    }
+}
@@ -21,6 +21,8 @@ using CUE4Parse.FileProvider.Vfs;
 using EpicManifestParser.Objects;
 
 using System.Runtime.InteropServices;
+using System.Security.Cryptography;
+using System.Text;
 using System.IO;
 
 // Global Provider
@@ -37,6 +39,9 @@ public class Globals
     public static bool bHideConsole;
     public ContentManager Manager = new ContentManager();
 
+    // Localization loaded after the API starts listening on warm starts, exports wait for it
+    public static Task Localization = Task.CompletedTask;
+
     public void WriteLog(string source, ConsoleColor Color, string description)
     {
         Console.ForegroundColor = Color;
@@ -87,10 +92,19 @@ public class Globals
         return values[0] == "True" ? true : false;
     }
 
+    // Project config folder, the API binary lives in <Project>/Plugins/.../Binaries/<Platform>/JsonAsAsset_API/
+    public static string GetConfigFolder()
+    {
+        string BaseDirectory = System.AppDomain.CurrentDomain.BaseDirectory;
+        string PluginsFolder = Path.DirectorySeparatorChar + "Plugins" + Path.DirectorySeparatorChar;
+
+        return Path.Combine(BaseDirectory.SubstringBeforeLast(PluginsFolder), "Config") + Path.DirectorySeparatorChar;
+    }
+
     // Find config folder & UpdateData
     public ConfigIni GetEditorConfig()
     {
-        string config_folder = System.AppDomain.CurrentDomain.BaseDirectory.SubstringBeforeLast("\\Plugins\\") + "\\Config\\";
+        string config_folder = GetConfigFolder();
         ConfigIni config = new ConfigIni("DefaultEditorPerProjectUserSettings");
         config.Read(File.OpenText(config_folder + "DefaultEditorPerProjectUserSettings.ini"));
 
@@ -108,16 +122,17 @@ public class Globals
         [DllImport("user32.dll")]
         static extern bool ShowWindow(IntPtr hWnd, int nCmdShow);
 
-        ShowWindow(GetConsoleWindow(), bHideConsole ? 0 : 5);
+        if (OperatingSystem.IsWindows())
+            ShowWindow(GetConsoleWindow(), bHideConsole ? 0 : 5);
 
-        if (MappingFilePath != "") WriteLog("UserSettings", ConsoleColor.Blue, $"Mappings: {MappingFilePath.SubstringBeforeLast("\\")}");
-        WriteLog("UserSettings", ConsoleColor.Blue, $"Archive Directory: {ArchiveDirectory.SubstringBeforeLast("\\")}");
+        if (MappingFilePath != "") WriteLog("UserSettings", ConsoleColor.Blue, $"Mappings: {Path.GetDirectoryName(MappingFilePath)}");
+        WriteLog("UserSettings", ConsoleColor.Blue, $"Archive Directory: {Path.GetDirectoryName(ArchiveDirectory)}");
         WriteLog("UserSettings", ConsoleColor.Blue, $"Unreal Versioning: {UnrealVersion.ToString()}");
 
         return config;
     }
 
-    private async Task<bool> InitializeContentBuilds()
+    private async Task<bool> InitializeContentBuilds(MountIndex Index)
     {
         // Find BuildInfo.ini by archive directory
         string BuildInfo = Path.Combine(ArchiveDirectory, "../../../Cloud/BuildInfo.ini");
@@ -130,17 +145,34 @@ public class Globals
             Label = InitEntries[0];
         }
 
-        ContentBuildResponse ContentBuilds = await Manager.GetContentBuilds(label: Label);
-        if (ContentBuilds == null) 
-            return false;
+        Manifest LocalManifest;
+
+        // Warm start, manifest for this label is already on disk
+        if (Index.LoadManifest(Label) is { } CachedManifest)
+        {
+            LocalManifest = Manager.LocalManifestManager.ReadManifest(CachedManifest);
+
+            WriteLog("ContentBuilds", ConsoleColor.Yellow, "Using cached manifest, reading..");
+        }
+        else
+        {
+            ContentBuildResponse ContentBuilds = await Manager.GetContentBuilds(label: Label);
+            if (ContentBuilds == null) 
+                return false;
+
+            WriteLog("ContentBuilds", ConsoleColor.Yellow, "Finding manifest..");
 
-        WriteLog("ContentBuilds", ConsoleColor.Yellow, "Finding manifest..");
+            // Construct Manifest
+            ContentBuildResponse.ContentItem _Manifest = ContentBuilds.Items.Manifest;
+            byte[]? ManifestData = await Manager.LocalManifestManager.DownloadManifest(url: (_Manifest.Distribution + _Manifest.Path));
+            if (ManifestData == null)
+                return false;
 
-        // Construct Manifest
-        ContentBuildResponse.ContentItem _Manifest = ContentBuilds.Items.Manifest;
-        Manifest LocalManifest = await Manager.LocalManifestManager.GetManifest(url: (_Manifest.Distribution + _Manifest.Path));
+            Index.StoreManifest(Label, ManifestData);
+            LocalManifest = Manager.LocalManifestManager.ReadManifest(ManifestData);
 
-        WriteLog("ContentBuilds", ConsoleColor.Yellow, "Downloaded manifest, reading..");
+            WriteLog("ContentBuilds", ConsoleColor.Yellow, "Downloaded manifest, reading..");
+        }
 
         int FileManifestLength = LocalManifest.FileManifests.Count;
 
@@ -166,11 +198,23 @@ public class Globals
         WriteLog("CORE", ConsoleColor.Green, "Initializing globals, and provider..");
 
         // Find config folder
-        string config_folder = System.AppDomain.CurrentDomain.BaseDirectory.SubstringBeforeLast("\\Plugins\\") + "\\Config\\";
-        WriteLog("Provider", ConsoleColor.Red, $"Found config folder: {config_folder.SubstringBeforeLast("\\")}");
+        string config_folder = GetConfigFolder();
+        WriteLog("Provider", ConsoleColor.Red, $"Found config folder: {config_folder.SubstringBeforeLast(Path.DirectorySeparatorChar)}");
 
         // DefaultEditorPerProjectUserSettings
         ConfigIni config = GetEditorConfig();
+        var DynamicKeys = GetArrayProperty(config, "DynamicKeys");
+
+        // Mount index from the last launch, only valid if the archives and settings haven't changed
+        string BuildInfo = bUseContentBuilds ? Path.Combine(ArchiveDirectory, "../../../Cloud/BuildInfo.ini") : "";
+        MountIndex Index = MountIndex.Load(config_folder + "JsonAsAssetAPI",
+            MountIndex.ComputeFingerprint(ArchiveDirectory, BuildInfo,
+                UnrealVersion.ToString(), ArchiveKey, MappingFilePath, bUseContentBuilds.ToString(), string.Join(";", DynamicKeys)
+            )
+        );
+
+        if (Index.bIsWarm)
+            WriteLog("Provider", ConsoleColor.Red, "Archives unchanged since last launch, using mount index");
 
         // Create new file provider
         Provider = new DefaultFileProvider(ArchiveDirectory, SearchOption.TopDirectoryOnly, true, new VersionContainer(UnrealVersion));
@@ -183,7 +227,6 @@ public class Globals
             WriteLog("Provider", ConsoleColor.Red, $"Submitted Archive Key: {ArchiveKey}");
         }
 
-        var DynamicKeys = GetArrayProperty(config, "DynamicKeys");
         if (DynamicKeys.Count() != 0)
             WriteLog("Provider", ConsoleColor.Red, "Reading " + DynamicKeys.Count() + " Dynamic Keys -------------------------------------------");
 
@@ -197,16 +240,45 @@ public class Globals
             var Key = entries[0].SubstringBeforeLast("\"").SubstringAfterLast("\"");
             var Guid = entries[1].SubstringBeforeLast("\"").SubstringAfterLast("\"");
 
-            await Provider.SubmitKeyAsync(new FGuid(Guid), new FAesKey(Key));
+            // Skip keys that didn't mount anything last time
+            if (!Index.ShouldSubmitKey(Guid))
+                continue;
+
+            int MountedCount = await Provider.SubmitKeyAsync(new FGuid(Guid), new FAesKey(Key));
+            Index.RecordKey(Guid, MountedCount);
+
             WriteLog("Provider", ConsoleColor.Red, $"Submitted Key: {Key}");
         }
 
         if (MappingFilePath != "") Provider.MappingsContainer = new FileUsmapTypeMappingsProvider(MappingFilePath);
-        Provider.LoadLocalization(ELanguage.English);
         Provider.LoadVirtualPaths();
 
         if (bUseContentBuilds)
-            await InitializeContentBuilds();
+            await InitializeContentBuilds(Index);
+
+        // Reading every locres is most of a warm start, the editor only needs it once it exports something
+        if (Index.bIsWarm)
+        {
+            DefaultFileProvider LocalizedProvider = Provider;
+            Localization = Task.Run(() =>
+            {
+                try
+                {
+                    LocalizedProvider.LoadLocalization(ELanguage.English);
+                }
+                catch (Exception e)
+                {
+                    // Exports still work without it, texts just aren't localized
+                    WriteLog("Provider", ConsoleColor.Red, $"Failed to load localization: {e.Message}");
+                }
+            });
+        }
+        else
+        {
+            Provider.LoadLocalization(ELanguage.English);
+        }
+
+        Index.Save();
     }
 }
 
@@ -228,14 +300,51 @@ namespace JsonAsAssetAPI.Controllers
             #pragma warning restore CS8601 // Possible null reference assignment.
         }
 
+        // Polled by the editor, the API only listens once the provider is initialized, so answering at all means it's ready
+        [HttpGet("/health")]
+        public ActionResult Health()
+        {
+            return Ok(new
+            {
+                status = "ready",
+                process = Environment.ProcessId
+            });
+        }
+
+        // Lets the editor stop an instance it didn't launch itself, without looking for it in the process list.
+        // Only with the token the instance was launched with (--shutdown-token), instances started by hand can't be stopped this way
+        [HttpPost("/api/v1/shutdown")]
+        public ActionResult Shutdown([FromServices] IHostApplicationLifetime Lifetime, [FromServices] IConfiguration Configuration)
+        {
+            var expected = Configuration["shutdown-token"];
+            string? token = Request.Headers["X-Shutdown-Token"];
+
+            if (string.IsNullOrEmpty(expected) || token == null ||
+                !CryptographicOperations.FixedTimeEquals(Encoding.UTF8.GetBytes(token), Encoding.UTF8.GetBytes(expected)))
+                return StatusCode(StatusCodes.Status403Forbidden);
+
+            Lifetime.StopApplication();
+            return Ok();
+        }
+
+        // Largest mip with data that fits in maxSize, or the smallest one if none does
+        private static FTexture2DMipMap? GetProxyMip(UTexture texture, int maxSize)
+        {
+            var mips = texture.PlatformData.Mips.Where(mip => mip.BulkData?.Data != null).ToArray();
+            return mips.FirstOrDefault(mip => Math.Max(mip.SizeX, mip.SizeY) <= maxSize) ?? mips.LastOrDefault();
+        }
+
+        // maxSize (texture data only) picks a smaller mip, its size is sent in the X-Mip-SizeX / X-Mip-SizeY headers
         [HttpGet("/api/v1/export")]
-        public ActionResult Get(bool raw, string path)
+        public ActionResult Get(bool raw, string path, int maxSize = 0)
         {
             var type = Request.Headers.ContentType;
 
             // Try to load object, if failed, return message
             try
             {
+                Globals.Localization.Wait();
+
                 path = path.SubstringBefore('.');
                 var LocalObject = Provider.LoadObject(path);
 
@@ -247,8 +356,18 @@ namespace JsonAsAssetAPI.Controllers
                             UTexture TextureObject = (UTexture)Provider.LoadObject(path);
 
                             // .bin support
-                            if (type == "application/octet-stream" && TextureObject.GetFirstMip().BulkData.Data is { } mipData)
-                                return File(mipData, type);
+                            if (type == "application/octet-stream")
+                            {
+                                var mip = maxSize > 0 ? GetProxyMip(TextureObject, maxSize) : TextureObject.GetFirstMip();
+
+                                if (mip?.BulkData?.Data is { } mipData)
+                                {
+                                    Response.Headers["X-Mip-SizeX"] = mip.SizeX.ToString();
+                                    Response.Headers["X-Mip-SizeY"] = mip.SizeY.ToString();
+
+                                    return File(mipData, type);
+                                }
+                            }
 
                             // Texture data
                             SKBitmap TextureData = TextureObject.Decode();
@@ -37,7 +37,21 @@ int nu_pixels, uint8_t * DETEX_RESTRICT target_pixel_buffer) {
 static void ConvertPixel32RGBA8ToPixel32BGRA8(uint8_t * DETEX_RESTRICT source_pixel_buffer, int nu_pixels,
 uint8_t * DETEX_RESTRICT target_pixel_buffer) {
 	uint32_t *source_pixel32_buffer = (uint32_t *)source_pixel_buffer;
-	for (int i = 0; i < nu_pixels; i++) {
+	int i = 0;
+#ifdef DETEX_USE_SSE2
+	/* Four pixels at a time, G and A stay, R and B trade places. */
+	const __m128i mask_ga = _mm_set1_epi32(0xFF00FF00);
+	const __m128i mask_b = _mm_set1_epi32(0x000000FF);
+	for (; i + 4 <= nu_pixels; i += 4) {
+		__m128i pixels = _mm_loadu_si128((const __m128i *)source_pixel32_buffer);
+		__m128i swapped = _mm_or_si128(_mm_and_si128(pixels, mask_ga),
+			_mm_or_si128(_mm_and_si128(_mm_srli_epi32(pixels, 16), mask_b),
+			_mm_slli_epi32(_mm_and_si128(pixels, mask_b), 16)));
+		_mm_storeu_si128((__m128i *)source_pixel32_buffer, swapped);
+		source_pixel32_buffer += 4;
+	}
+#endif
+	for (; i < nu_pixels; i++) {
 		/* Swap R and B. */
 		uint32_t pixel = *source_pixel32_buffer;
 		pixel = detexPack32RGBA8(
@@ -54,7 +68,18 @@ uint8_t * DETEX_RESTRICT target_pixel_buffer) {
 static void ConvertPixel64RGBX16ToPixel64BGRX16(uint8_t * DETEX_RESTRICT source_pixel_buffer, int nu_pixels,
 uint8_t * DETEX_RESTRICT target_pixel_buffer) {
 	uint64_t *source_pixel64_buffer = (uint64_t *)source_pixel_buffer;
-	for (int i = 0; i < nu_pixels; i++) {
+	int i = 0;
+#ifdef DETEX_USE_SSE2
+	/* Two pixels at a time, 16-bit words 0 and 2 of each pixel are swapped. */
+	for (; i + 2 <= nu_pixels; i += 2) {
+		__m128i pixels = _mm_loadu_si128((const __m128i *)source_pixel64_buffer);
+		pixels = _mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 0, 1, 2));
+		pixels = _mm_shufflehi_epi16(pixels, _MM_SHUFFLE(3, 0, 1, 2));
+		_mm_storeu_si128((__m128i *)source_pixel64_buffer, pixels);
+		source_pixel64_buffer += 2;
+	}
+#endif
+	for (; i < nu_pixels; i++) {
 		/* Swap R and B (16-bit). */
 		uint64_t pixel = *source_pixel64_buffer;
 		pixel = detexPack64RGBA16(
@@ -68,6 +93,30 @@ uint8_t * DETEX_RESTRICT target_pixel_buffer) {
 	}
 }
 
+// Half-float RGBX16 to RGBA16 (in-place), alpha is set to 1.0.
+
+static void ConvertPixel64FloatRGBX16ToPixel64FloatRGBA16(uint8_t * DETEX_RESTRICT source_pixel_buffer,
+int nu_pixels, uint8_t * DETEX_RESTRICT target_pixel_buffer) {
+	const uint64_t alpha_one = (uint64_t)0x3C00 << 48;
+	const uint64_t mask_rgb = ((uint64_t)1 << 48) - 1;
+	uint64_t *source_pixel64_buffer = (uint64_t *)source_pixel_buffer;
+	int i = 0;
+#ifdef DETEX_USE_SSE2
+	const __m128i sse_alpha_one = _mm_set1_epi64x(alpha_one);
+	const __m128i sse_mask_rgb = _mm_set1_epi64x(mask_rgb);
+	for (; i + 2 <= nu_pixels; i += 2) {
+		__m128i pixels = _mm_loadu_si128((const __m128i *)source_pixel64_buffer);
+		pixels = _mm_or_si128(_mm_and_si128(pixels, sse_mask_rgb), sse_alpha_one);
+		_mm_storeu_si128((__m128i *)source_pixel64_buffer, pixels);
+		source_pixel64_buffer += 2;
+	}
+#endif
+	for (; i < nu_pixels; i++) {
+		*source_pixel64_buffer = (*source_pixel64_buffer & mask_rgb) | alpha_one;
+		source_pixel64_buffer++;
+	}
+}
+
 // Swapping red and blue (not in-place).
 #if 0
 static void ConvertPixel24RGB8ToPixel32BGRX8(uint8_t * DETEX_RESTRICT source_pixel_buffer, int nu_pixels,
@@ -776,6 +825,9 @@ detexConversionType detex_conversion_table[] = {
 	{ DETEX_PIXEL_FORMAT_BGRA8, DETEX_PIXEL_FORMAT_RGBA8, ConvertPixel32RGBA8ToPixel32BGRA8 },
 	{ DETEX_PIXEL_FORMAT_FLOAT_RGBX16, DETEX_PIXEL_FORMAT_FLOAT_BGRX16, ConvertPixel64RGBX16ToPixel64BGRX16 },
 	{ DETEX_PIXEL_FORMAT_FLOAT_BGRX16, DETEX_PIXEL_FORMAT_FLOAT_RGBX16, ConvertPixel64RGBX16ToPixel64BGRX16 },
+	// Half-float alpha (in-place).
+	{ DETEX_PIXEL_FORMAT_FLOAT_RGBX16, DETEX_PIXEL_FORMAT_FLOAT_RGBA16, ConvertPixel64FloatRGBX16ToPixel64FloatRGBA16 },
+	{ DETEX_PIXEL_FORMAT_FLOAT_RGBA16, DETEX_PIXEL_FORMAT_FLOAT_RGBX16, ConvertNoop },
 #if 0
 	// Swapping red and blue (not in-place)
 	{ DETEX_PIXEL_FORMAT_RGB8, DETEX_PIXEL_FORMAT_BGRX8, ConvertPixel24RGB8ToPixel32BGRX8 },
@@ -826,12 +878,14 @@ detexConversionType detex_conversion_table[] = {
 	{ DETEX_PIXEL_FORMAT_FLOAT_R16_HDR, DETEX_PIXEL_FORMAT_R16, ConvertPixel16FloatR16HDRToPixel16R16 },
 	{ DETEX_PIXEL_FORMAT_FLOAT_RG16_HDR, DETEX_PIXEL_FORMAT_RG16, ConvertPixel32FloatRG16HDRToPixel32RG16 },
 	{ DETEX_PIXEL_FORMAT_FLOAT_RGBX16_HDR, DETEX_PIXEL_FORMAT_RGBX16, ConvertPixel64FloatRGBX16HDRToPixel64RGBX16 },
+#endif
 	// Float to half-float conversion.
 	// 47
 	{ DETEX_PIXEL_FORMAT_FLOAT_R32, DETEX_PIXEL_FORMAT_FLOAT_R16, ConvertPixel32FloatR32ToPixel16FloatR16 },
 	{ DETEX_PIXEL_FORMAT_FLOAT_RG32, DETEX_PIXEL_FORMAT_FLOAT_RG16, ConvertPixel64FloatRG32ToPixel32FloatRG16 },
 	{ DETEX_PIXEL_FORMAT_FLOAT_RGB32, DETEX_PIXEL_FORMAT_FLOAT_RGB16, ConvertPixel96FloatRGB32ToPixel48FloatRGB16 },
 	{ DETEX_PIXEL_FORMAT_FLOAT_RGBX32, DETEX_PIXEL_FORMAT_FLOAT_RGBX16, ConvertPixel128FloatRGBX32ToPixel64FloatRGBX16 },
+#if 0
 	// Float to 16-bit integer conversion.
 	{ DETEX_PIXEL_FORMAT_FLOAT_R32, DETEX_PIXEL_FORMAT_R16, ConvertPixel32FloatR32ToPixel16R16 },
 	{ DETEX_PIXEL_FORMAT_FLOAT_RG32, DETEX_PIXEL_FORMAT_RG16, ConvertPixel64FloatRG32ToPixel32RG16 },
@@ -1052,75 +1106,108 @@ uint32_t *conversion) {
 	return - 1;
 }
 
-// Temporary pixel buffer management for conversion function.
+// Temporary pixel buffer management for conversion function. Buffers are taken
+// from the caller's scratch memory when there is any, and allocated otherwise.
 
 #define DETEX_MAX_TEMP_PIXEL_BUFFERS 3
 
 typedef struct {
 	uint8_t *pixel_buffer[DETEX_MAX_TEMP_PIXEL_BUFFERS];
-	uint32_t size[DETEX_MAX_TEMP_PIXEL_BUFFERS];
+	bool allocated[DETEX_MAX_TEMP_PIXEL_BUFFERS];
 	int nu_buffers;
+	uint8_t *scratch_buffer;
+	uint32_t scratch_size;
 } TempPixelBufferInfo;
 
-static void InitTemporaryPixelBuffers(TempPixelBufferInfo *info) {
+static void InitTemporaryPixelBuffers(TempPixelBufferInfo *info, uint8_t *scratch_buffer,
+uint32_t scratch_size) {
 	info->nu_buffers = 0;
+	info->scratch_buffer = scratch_buffer;
+	info->scratch_size = scratch_buffer != NULL ? scratch_size : 0;
 }
 
 static uint8_t *AllocateTemporaryPixelBuffer(TempPixelBufferInfo *info, uint32_t size) {
 	if (info->nu_buffers == DETEX_MAX_TEMP_PIXEL_BUFFERS)
 		return NULL;
-	uint8_t *buffer = (uint8_t *)malloc(size);
+	uint8_t *buffer;
+	bool allocated = false;
+	if (size <= info->scratch_size) {
+		buffer = info->scratch_buffer;
+		info->scratch_buffer += size;
+		info->scratch_size -= size;
+	}
+	else {
+		buffer = (uint8_t *)detexMalloc(size);
+		allocated = true;
+	}
 	info->pixel_buffer[info->nu_buffers] = buffer;
+	info->allocated[info->nu_buffers] = allocated;
 	info->nu_buffers++;
 	return buffer;
 }
 
 static void FreeTemporaryPixelBuffers(TempPixelBufferInfo *info) {
 	for (int i = 0; i < info->nu_buffers; i++)
-		free(info->pixel_buffer[i]);
+		if (info->allocated[i])
+			detexFree(info->pixel_buffer[i]);
 }
 
-// Convert pixels between different formats. Return true if successful.
-// If target_pixel_format is NULL, the conversion will be attempted in-place, without
-// allocating any temporary buffer.
+// Resolve the conversion steps between two pixel formats, so they can be reused
+// for any number of pixel buffers. Returns true if successful.
 
-bool detexConvertPixels(uint8_t * DETEX_RESTRICT source_pixel_buffer, uint32_t nu_pixels,
-uint32_t source_pixel_format, uint8_t * DETEX_RESTRICT target_pixel_buffer,
-uint32_t target_pixel_format) {
-//	printf("Converting between %s and %s (0x%08X and 0x%08X).\n", detexGetTextureFormatText(source_pixel_format),
-//		detexGetTextureFormatText(target_pixel_format), source_pixel_format, target_pixel_format);
-	if (source_pixel_format == target_pixel_format) {
-		if (target_pixel_buffer != NULL)
-			memcpy(target_pixel_buffer, source_pixel_buffer, nu_pixels *
-				detexGetPixelSize(source_pixel_format));
+bool detexResolveConversion(uint32_t source_pixel_format, uint32_t target_pixel_format,
+detexConversion *conversion) {
+	conversion->source_pixel_format = source_pixel_format;
+	conversion->target_pixel_format = target_pixel_format;
+	conversion->nu_conversions = 0;
+	conversion->nu_non_in_place_conversions = 0;
+	conversion->first_non_in_place_conversion = - 1;
+	conversion->last_non_in_place_conversion = - 1;
+	if (source_pixel_format == target_pixel_format)
 		return true;
-	}
-	uint32_t conversion[4];
-	int nu_conversions = detexMatchConversion(source_pixel_format, target_pixel_format, conversion);
+	int nu_conversions = detexMatchConversion(source_pixel_format, target_pixel_format,
+		conversion->conversion);
 	if (nu_conversions < 0) {
 		detexSetErrorMessage("detexConvertPixels: Unable to find conversion path");
 		return false;
 	}
+	conversion->nu_conversions = nu_conversions;
 	// Count in place/non-place steps.
-	int nu_non_in_place_conversions = 0;
-	int last_non_in_place_conversion = - 1;
-	int first_non_in_place_conversion = - 1;
 	for (int i = 0; i < nu_conversions; i++)
-		if (detexGetPixelSize(detex_conversion_table[conversion[i]].source_format)
-		!= detexGetPixelSize(detex_conversion_table[conversion[i]].target_format)) {
-			nu_non_in_place_conversions++;
-			last_non_in_place_conversion = i;
-			if (first_non_in_place_conversion < 0)
-				first_non_in_place_conversion = i;
+		if (detexGetPixelSize(detex_conversion_table[conversion->conversion[i]].source_format)
+		!= detexGetPixelSize(detex_conversion_table[conversion->conversion[i]].target_format)) {
+			conversion->nu_non_in_place_conversions++;
+			conversion->last_non_in_place_conversion = i;
+			if (conversion->first_non_in_place_conversion < 0)
+				conversion->first_non_in_place_conversion = i;
 		}
-	if (target_pixel_buffer == NULL && nu_non_in_place_conversions > 0) {
+	return true;
+}
+
+// Convert pixels with a resolved conversion. Return true if successful.
+// If target_pixel_format is NULL, the conversion will be attempted in-place, without
+// allocating any temporary buffer. Temporary buffers are taken from scratch_buffer
+// (DETEX_CONVERSION_SCRATCH_SIZE(nu_pixels) bytes) when it isn't NULL.
+
+bool detexConvertPixelsResolved(const detexConversion *conversion,
+uint8_t * DETEX_RESTRICT source_pixel_buffer, uint32_t nu_pixels,
+uint8_t * DETEX_RESTRICT target_pixel_buffer, uint8_t *scratch_buffer) {
+	uint32_t source_pixel_format = conversion->source_pixel_format;
+	if (conversion->nu_conversions == 0) {
+		if (target_pixel_buffer != NULL)
+			memcpy(target_pixel_buffer, source_pixel_buffer, nu_pixels *
+				detexGetPixelSize(source_pixel_format));
+		return true;
+	}
+	if (target_pixel_buffer == NULL && conversion->nu_non_in_place_conversions > 0) {
 		detexSetErrorMessage("Unable to find in-place conversion path");
 		return false;
 	}
 	// Perform conversions.
 	TempPixelBufferInfo temp_pixel_buffer_info;
-	InitTemporaryPixelBuffers(&temp_pixel_buffer_info);
-	if (first_non_in_place_conversion > 0) {
+	InitTemporaryPixelBuffers(&temp_pixel_buffer_info, scratch_buffer,
+		DETEX_CONVERSION_SCRATCH_SIZE(nu_pixels));
+	if (conversion->first_non_in_place_conversion > 0) {
 		// When doing a non-place conversion and the first conversion step is in-place,
 		// allocate a temporary buffer to avoid corrupting the source buffer.
 		uint8_t *temp_pixel_buffer = AllocateTemporaryPixelBuffer(&temp_pixel_buffer_info,
@@ -1129,38 +1216,34 @@ uint32_t target_pixel_format) {
 			detexGetPixelSize(source_pixel_format) * nu_pixels);
 		source_pixel_buffer = temp_pixel_buffer;
 	}
-	if (target_pixel_buffer != NULL && nu_non_in_place_conversions == 0) {
+	if (target_pixel_buffer != NULL && conversion->nu_non_in_place_conversions == 0) {
 		// When doing a non-in-place conversion with only in-place conversion steps,
 		// start by copying the source buffer to the target buffer.
 		memcpy(target_pixel_buffer, source_pixel_buffer,
 			detexGetPixelSize(source_pixel_format) * nu_pixels);
 		source_pixel_buffer = target_pixel_buffer;
 	}
-	for (int i = 0; i < nu_conversions; i++) {
-		if (detexGetPixelSize(detex_conversion_table[conversion[i]].source_format)
-		== detexGetPixelSize(detex_conversion_table[conversion[i]].target_format)) {
+	for (int i = 0; i < conversion->nu_conversions; i++) {
+		const detexConversionType *step = &detex_conversion_table[conversion->conversion[i]];
+		if (detexGetPixelSize(step->source_format) == detexGetPixelSize(step->target_format)) {
 			// In-place conversion step.
-			detex_conversion_table[conversion[i]].conversion_func(
-				source_pixel_buffer, nu_pixels, NULL);
+			step->conversion_func(source_pixel_buffer, nu_pixels, NULL);
 		}
 		else {
-			if (i == last_non_in_place_conversion) {
-				detex_conversion_table[conversion[i]].conversion_func(
-					source_pixel_buffer, nu_pixels, target_pixel_buffer);
+			if (i == conversion->last_non_in_place_conversion) {
+				step->conversion_func(source_pixel_buffer, nu_pixels, target_pixel_buffer);
 				source_pixel_buffer = target_pixel_buffer;
 			}
 			else {
 				uint8_t *temp_pixel_buffer = AllocateTemporaryPixelBuffer(&temp_pixel_buffer_info,
-					nu_pixels * detexGetPixelSize(
-						detex_conversion_table[conversion[i]].target_format));
+					nu_pixels * detexGetPixelSize(step->target_format));
 				if (temp_pixel_buffer == NULL) {
 					// Error: Too many temporary buffers needed.
 					detexSetErrorMessage("detexConvertPixels: Too many temporary buffers needed");
 					FreeTemporaryPixelBuffers(&temp_pixel_buffer_info);
 					return false;
 				}
-				detex_conversion_table[conversion[i]].conversion_func(
-					source_pixel_buffer, nu_pixels, temp_pixel_buffer);
+				step->conversion_func(source_pixel_buffer, nu_pixels, temp_pixel_buffer);
 				source_pixel_buffer = temp_pixel_buffer;
 			}
 		}
@@ -1170,6 +1253,22 @@ uint32_t target_pixel_format) {
 	return true;
 }
 
+// Convert pixels between different formats. Return true if successful.
+// If target_pixel_format is NULL, the conversion will be attempted in-place, without
+// allocating any temporary buffer.
+
+bool detexConvertPixels(uint8_t * DETEX_RESTRICT source_pixel_buffer, uint32_t nu_pixels,
+uint32_t source_pixel_format, uint8_t * DETEX_RESTRICT target_pixel_buffer,
+uint32_t target_pixel_format) {
+//	printf("Converting between %s and %s (0x%08X and 0x%08X).\n", detexGetTextureFormatText(source_pixel_format),
+//		detexGetTextureFormatText(target_pixel_format), source_pixel_format, target_pixel_format);
+	detexConversion conversion;
+	if (!detexResolveConversion(source_pixel_format, target_pixel_format, &conversion))
+		return false;
+	return detexConvertPixelsResolved(&conversion, source_pixel_buffer, nu_pixels,
+		target_pixel_buffer, NULL);
+}
+
 bool detexConvertPixelsInPlace(uint8_t * DETEX_RESTRICT source_pixel_buffer, uint32_t nu_pixels,
 uint32_t source_pixel_format, uint32_t target_pixel_format) {
 	return detexConvertPixels(source_pixel_buffer, nu_pixels, source_pixel_format, NULL, target_pixel_format);
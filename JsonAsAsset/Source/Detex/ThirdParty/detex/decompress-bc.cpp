@@ -0,0 +1,351 @@
+/*
+
+Copyright (c) 2015 Harm Hanemaaijer <fgenfb@yahoo.com>
+
+Permission to use, copy, modify, and/or distribute this software for any
+purpose with or without fee is hereby granted, provided that the above
+copyright notice and this permission notice appear in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+*/
+
+#include <string.h>
+#include <math.h>
+
+#include "detex.h"
+#include "misc.h"
+
+/*
+ * BC1 (DXT1), BC2 (DXT3), BC3 (DXT5), BC4 (RGTC1) and BC5 (RGTC2) decoding
+ * straight into BGRA8 rows.
+ *
+ * The results match NVTT's decoder (nv::DirectDrawSurface) bit for bit, which
+ * is what the textures were imported with before: the color part of BC2/BC3
+ * blocks also uses the three color mode when color0 <= color1, BC4 is
+ * replicated into gray, and the BC5 normal Z is computed like NVTT does it.
+ *
+ * A block is decoded as four 16-byte channels (4x4 pixels, row by row). The
+ * palette lookups and the interleaving into BGRA rows are vectorized with SSE2
+ * or NEON, and done one pixel at a time elsewhere.
+ */
+
+// Decoded block, one channel per array.
+typedef struct {
+	uint8_t b[16];
+	uint8_t g[16];
+	uint8_t r[16];
+	uint8_t a[16];
+} detexBlockChannels;
+
+// Spread the indices of one block row (4 fields of 2 or 3 bits) into the four
+// bytes of a 32-bit word.
+static DETEX_INLINE_ONLY uint32_t SpreadIndices2(uint32_t bits) {
+	return (bits & 0x3) | ((bits & 0xC) << 6) | ((bits & 0x30) << 12) | ((bits & 0xC0) << 18);
+}
+
+static DETEX_INLINE_ONLY uint32_t SpreadIndices3(uint32_t bits) {
+	return (bits & 0x7) | ((bits & 0x38) << 5) | ((bits & 0x1C0) << 10) | ((bits & 0xE00) << 15);
+}
+
+// out[i] = palette[index[i]], for the 16 indices of a block (one row per word,
+// all below nu_entries, at most 8).
+static DETEX_INLINE_ONLY void Lookup16(const uint32_t *index_rows,
+const uint8_t * DETEX_RESTRICT palette, int nu_entries, uint8_t * DETEX_RESTRICT out) {
+#if defined(DETEX_USE_SSE2)
+	__m128i indices = _mm_set_epi32((int)index_rows[3], (int)index_rows[2], (int)index_rows[1],
+		(int)index_rows[0]);
+	__m128i result = _mm_setzero_si128();
+	for (int k = 0; k < nu_entries; k++) {
+		__m128i match = _mm_cmpeq_epi8(indices, _mm_set1_epi8((char)k));
+		result = _mm_or_si128(result, _mm_and_si128(match, _mm_set1_epi8((char)palette[k])));
+	}
+	_mm_storeu_si128((__m128i *)out, result);
+#elif defined(DETEX_USE_NEON)
+	uint8_t table[16] = { 0 };
+	memcpy(table, palette, nu_entries);
+	uint8x16_t indices = vreinterpretq_u8_u32(vld1q_u32(index_rows));
+	vst1q_u8(out, vqtbl1q_u8(vld1q_u8(table), indices));
+#else
+	for (int i = 0; i < 16; i++)
+		out[i] = palette[(index_rows[i >> 2] >> ((i & 3) * 8)) & 0xFF];
+#endif
+}
+
+// Four lookups with the same 2-bit indices, for the color part of a block.
+static DETEX_INLINE_ONLY void LookupColor(const uint32_t *index_rows, const uint8_t *pal_r,
+const uint8_t *pal_g, const uint8_t *pal_b, const uint8_t *pal_a, detexBlockChannels *channels) {
+#if defined(DETEX_USE_SSE2)
+	__m128i indices = _mm_set_epi32((int)index_rows[3], (int)index_rows[2], (int)index_rows[1],
+		(int)index_rows[0]);
+	__m128i r = _mm_setzero_si128();
+	__m128i g = _mm_setzero_si128();
+	__m128i b = _mm_setzero_si128();
+	__m128i a = _mm_setzero_si128();
+	for (int k = 0; k < 4; k++) {
+		__m128i match = _mm_cmpeq_epi8(indices, _mm_set1_epi8((char)k));
+		r = _mm_or_si128(r, _mm_and_si128(match, _mm_set1_epi8((char)pal_r[k])));
+		g = _mm_or_si128(g, _mm_and_si128(match, _mm_set1_epi8((char)pal_g[k])));
+		b = _mm_or_si128(b, _mm_and_si128(match, _mm_set1_epi8((char)pal_b[k])));
+		a = _mm_or_si128(a, _mm_and_si128(match, _mm_set1_epi8((char)pal_a[k])));
+	}
+	_mm_storeu_si128((__m128i *)channels->r, r);
+	_mm_storeu_si128((__m128i *)channels->g, g);
+	_mm_storeu_si128((__m128i *)channels->b, b);
+	_mm_storeu_si128((__m128i *)channels->a, a);
+#else
+	Lookup16(index_rows, pal_r, 4, channels->r);
+	Lookup16(index_rows, pal_g, 4, channels->g);
+	Lookup16(index_rows, pal_b, 4, channels->b);
+	Lookup16(index_rows, pal_a, 4, channels->a);
+#endif
+}
+
+static DETEX_INLINE_ONLY void Fill16(uint8_t *out, uint8_t value) {
+	memset(out, value, 16);
+}
+
+// Same as NVTT's BlockDXT1::evaluatePalette (bit expansion, then interpolation).
+static DETEX_INLINE_ONLY void DecodeColorBlock(const uint8_t *bitstring,
+detexBlockChannels *channels) {
+	uint32_t color0 = bitstring[0] | ((uint32_t)bitstring[1] << 8);
+	uint32_t color1 = bitstring[2] | ((uint32_t)bitstring[3] << 8);
+	uint8_t pal_r[4], pal_g[4], pal_b[4], pal_a[4];
+	uint32_t r0 = (color0 >> 11) & 0x1F, g0 = (color0 >> 5) & 0x3F, b0 = color0 & 0x1F;
+	uint32_t r1 = (color1 >> 11) & 0x1F, g1 = (color1 >> 5) & 0x3F, b1 = color1 & 0x1F;
+	pal_r[0] = (uint8_t)((r0 << 3) | (r0 >> 2));
+	pal_g[0] = (uint8_t)((g0 << 2) | (g0 >> 4));
+	pal_b[0] = (uint8_t)((b0 << 3) | (b0 >> 2));
+	pal_r[1] = (uint8_t)((r1 << 3) | (r1 >> 2));
+	pal_g[1] = (uint8_t)((g1 << 2) | (g1 >> 4));
+	pal_b[1] = (uint8_t)((b1 << 3) | (b1 >> 2));
+	pal_a[0] = pal_a[1] = pal_a[2] = 0xFF;
+	if (color0 > color1) {
+		pal_r[2] = (uint8_t)((2 * pal_r[0] + pal_r[1]) / 3);
+		pal_g[2] = (uint8_t)((2 * pal_g[0] + pal_g[1]) / 3);
+		pal_b[2] = (uint8_t)((2 * pal_b[0] + pal_b[1]) / 3);
+		pal_r[3] = (uint8_t)((2 * pal_r[1] + pal_r[0]) / 3);
+		pal_g[3] = (uint8_t)((2 * pal_g[1] + pal_g[0]) / 3);
+		pal_b[3] = (uint8_t)((2 * pal_b[1] + pal_b[0]) / 3);
+		pal_a[3] = 0xFF;
+	}
+	else {
+		pal_r[2] = (uint8_t)((pal_r[0] + pal_r[1]) / 2);
+		pal_g[2] = (uint8_t)((pal_g[0] + pal_g[1]) / 2);
+		pal_b[2] = (uint8_t)((pal_b[0] + pal_b[1]) / 2);
+		// Transparent black.
+		pal_r[3] = pal_g[3] = pal_b[3] = pal_a[3] = 0;
+	}
+	uint32_t index_rows[4];
+	for (int row = 0; row < 4; row++)
+		index_rows[row] = SpreadIndices2(bitstring[4 + row]);
+	LookupColor(index_rows, pal_r, pal_g, pal_b, pal_a, channels);
+}
+
+// Same as NVTT's AlphaBlockDXT5::evaluatePalette, used for BC3 alpha and BC4/BC5.
+static DETEX_INLINE_ONLY void DecodeAlphaBlock(const uint8_t *bitstring, uint8_t *out) {
+	uint32_t alpha0 = bitstring[0];
+	uint32_t alpha1 = bitstring[1];
+	uint8_t palette[8];
+	palette[0] = (uint8_t)alpha0;
+	palette[1] = (uint8_t)alpha1;
+	if (alpha0 > alpha1) {
+		for (int k = 2; k < 8; k++)
+			palette[k] = (uint8_t)(((8 - k) * alpha0 + (k - 1) * alpha1) / 7);
+	}
+	else {
+		for (int k = 2; k < 6; k++)
+			palette[k] = (uint8_t)(((6 - k) * alpha0 + (k - 1) * alpha1) / 5);
+		palette[6] = 0x00;
+		palette[7] = 0xFF;
+	}
+	uint64_t indices = 0;
+	for (int i = 0; i < 6; i++)
+		indices |= (uint64_t)bitstring[2 + i] << (i * 8);
+	uint32_t index_rows[4];
+	for (int row = 0; row < 4; row++)
+		index_rows[row] = SpreadIndices3((uint32_t)(indices >> (row * 12)) & 0xFFF);
+	Lookup16(index_rows, palette, 8, out);
+}
+
+// BC2 explicit 4-bit alpha.
+static DETEX_INLINE_ONLY void DecodeExplicitAlphaBlock(const uint8_t *bitstring, uint8_t *out) {
+	for (int i = 0; i < 8; i++) {
+		uint8_t low = bitstring[i] & 0x0F;
+		uint8_t high = bitstring[i] >> 4;
+		out[i * 2] = (uint8_t)((low << 4) | low);
+		out[i * 2 + 1] = (uint8_t)((high << 4) | high);
+	}
+}
+
+// Normal Z from X and Y, as NVTT's buildNormal (including the truncation).
+static DETEX_INLINE_ONLY void ReconstructNormalZ(const uint8_t * DETEX_RESTRICT x,
+const uint8_t * DETEX_RESTRICT y, uint8_t * DETEX_RESTRICT z) {
+	int i = 0;
+#if defined(DETEX_USE_SSE2)
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 two = _mm_set1_ps(2.0f);
+	const __m128 scale = _mm_set1_ps(255.0f);
+	const __m128i zero = _mm_setzero_si128();
+	__m128i x8 = _mm_loadu_si128((const __m128i *)x);
+	__m128i y8 = _mm_loadu_si128((const __m128i *)y);
+	__m128i x16[2] = { _mm_unpacklo_epi8(x8, zero), _mm_unpackhi_epi8(x8, zero) };
+	__m128i y16[2] = { _mm_unpacklo_epi8(y8, zero), _mm_unpackhi_epi8(y8, zero) };
+	__m128i z32[4];
+	for (int j = 0; j < 4; j++) {
+		__m128i x32 = (j & 1) ? _mm_unpackhi_epi16(x16[j >> 1], zero) : _mm_unpacklo_epi16(x16[j >> 1], zero);
+		__m128i y32 = (j & 1) ? _mm_unpackhi_epi16(y16[j >> 1], zero) : _mm_unpacklo_epi16(y16[j >> 1], zero);
+		__m128 nx = _mm_sub_ps(_mm_mul_ps(two, _mm_div_ps(_mm_cvtepi32_ps(x32), scale)), one);
+		__m128 ny = _mm_sub_ps(_mm_mul_ps(two, _mm_div_ps(_mm_cvtepi32_ps(y32), scale)), one);
+		__m128 t = _mm_sub_ps(_mm_sub_ps(one, _mm_mul_ps(nx, nx)), _mm_mul_ps(ny, ny));
+		__m128 nz = _mm_sqrt_ps(_mm_max_ps(t, _mm_setzero_ps()));
+		z32[j] = _mm_cvttps_epi32(_mm_div_ps(_mm_mul_ps(scale, _mm_add_ps(nz, one)), two));
+	}
+	// Saturating packs clamp to [0, 255].
+	__m128i z16lo = _mm_packs_epi32(z32[0], z32[1]);
+	__m128i z16hi = _mm_packs_epi32(z32[2], z32[3]);
+	_mm_storeu_si128((__m128i *)z, _mm_packus_epi16(z16lo, z16hi));
+	i = 16;
+#endif
+	for (; i < 16; i++) {
+		float nx = 2 * (x[i] / 255.0f) - 1;
+		float ny = 2 * (y[i] / 255.0f) - 1;
+		float nz = 0.0f;
+		if (1 - nx * nx - ny * ny > 0)
+			nz = sqrtf(1 - nx * nx - ny * ny);
+		int value = (int)(255.0f * (nz + 1) / 2.0f);
+		z[i] = (uint8_t)(value < 0 ? 0 : (value > 255 ? 255 : value));
+	}
+}
+
+// Returns false (channels left unset) if the format isn't one of BC1-BC5.
+static DETEX_INLINE_ONLY bool DecodeBlockChannels(uint32_t texture_format, const uint8_t *bitstring,
+uint32_t flags, detexBlockChannels *channels) {
+	switch (texture_format) {
+	case DETEX_TEXTURE_FORMAT_BC1:
+	case DETEX_TEXTURE_FORMAT_BC1A:
+		DecodeColorBlock(bitstring, channels);
+		break;
+	case DETEX_TEXTURE_FORMAT_BC2:
+		DecodeColorBlock(bitstring + 8, channels);
+		DecodeExplicitAlphaBlock(bitstring, channels->a);
+		break;
+	case DETEX_TEXTURE_FORMAT_BC3:
+		DecodeColorBlock(bitstring + 8, channels);
+		DecodeAlphaBlock(bitstring, channels->a);
+		break;
+	case DETEX_TEXTURE_FORMAT_RGTC1:
+		DecodeAlphaBlock(bitstring, channels->r);
+		memcpy(channels->g, channels->r, 16);
+		memcpy(channels->b, channels->r, 16);
+		Fill16(channels->a, 0xFF);
+		break;
+	case DETEX_TEXTURE_FORMAT_RGTC2:
+		DecodeAlphaBlock(bitstring, channels->r);
+		DecodeAlphaBlock(bitstring + 8, channels->g);
+		if (flags & DETEX_DECOMPRESS_FLAG_NORMAL_Z)
+			ReconstructNormalZ(channels->r, channels->g, channels->b);
+		else
+			Fill16(channels->b, 0);
+		Fill16(channels->a, 0xFF);
+		break;
+	default:
+		return false;
+	}
+	return true;
+}
+
+// Interleave the channels into BGRA8 rows (the block may be cut off at the
+// right and bottom edges of the texture).
+static DETEX_INLINE_ONLY void StoreBlockBGRA8(const detexBlockChannels *channels,
+uint8_t *pixel_buffer, uint32_t row_pitch, int nu_columns, int nu_rows) {
+	uint8_t block[64];
+#if defined(DETEX_USE_SSE2)
+	__m128i b = _mm_loadu_si128((const __m128i *)channels->b);
+	__m128i g = _mm_loadu_si128((const __m128i *)channels->g);
+	__m128i r = _mm_loadu_si128((const __m128i *)channels->r);
+	__m128i a = _mm_loadu_si128((const __m128i *)channels->a);
+	__m128i bg_lo = _mm_unpacklo_epi8(b, g);
+	__m128i bg_hi = _mm_unpackhi_epi8(b, g);
+	__m128i ra_lo = _mm_unpacklo_epi8(r, a);
+	__m128i ra_hi = _mm_unpackhi_epi8(r, a);
+	__m128i rows[4] = {
+		_mm_unpacklo_epi16(bg_lo, ra_lo), _mm_unpackhi_epi16(bg_lo, ra_lo),
+		_mm_unpacklo_epi16(bg_hi, ra_hi), _mm_unpackhi_epi16(bg_hi, ra_hi)
+	};
+	if (nu_columns == 4) {
+		for (int row = 0; row < nu_rows; row++)
+			_mm_storeu_si128((__m128i *)(pixel_buffer + row * row_pitch), rows[row]);
+		return;
+	}
+	for (int row = 0; row < 4; row++)
+		_mm_storeu_si128((__m128i *)(block + row * 16), rows[row]);
+#elif defined(DETEX_USE_NEON)
+	uint8x16x4_t bgra;
+	bgra.val[0] = vld1q_u8(channels->b);
+	bgra.val[1] = vld1q_u8(channels->g);
+	bgra.val[2] = vld1q_u8(channels->r);
+	bgra.val[3] = vld1q_u8(channels->a);
+	vst4q_u8(block, bgra);
+#else
+	for (int i = 0; i < 16; i++) {
+		block[i * 4 + 0] = channels->b[i];
+		block[i * 4 + 1] = channels->g[i];
+		block[i * 4 + 2] = channels->r[i];
+		block[i * 4 + 3] = channels->a[i];
+	}
+#endif
+	for (int row = 0; row < nu_rows; row++)
+		memcpy(pixel_buffer + row * row_pitch, block + row * 16, nu_columns * 4);
+}
+
+/*
+ * Decode a range of block rows of a BC1-BC5 texture into BGRA8 rows, row_pitch
+ * bytes apart. Returns false if the texture format isn't one of them.
+ */
+bool detexDecompressTextureRowsBGRA8(const detexTexture *texture, uint8_t * DETEX_RESTRICT pixel_buffer,
+uint32_t row_pitch, int first_block_row, int nu_block_rows, uint32_t flags) {
+	switch (texture->format) {
+	case DETEX_TEXTURE_FORMAT_BC1:
+	case DETEX_TEXTURE_FORMAT_BC1A:
+	case DETEX_TEXTURE_FORMAT_BC2:
+	case DETEX_TEXTURE_FORMAT_BC3:
+	case DETEX_TEXTURE_FORMAT_RGTC1:
+	case DETEX_TEXTURE_FORMAT_RGTC2:
+		break;
+	default:
+		detexSetErrorMessage("detexDecompressTextureRowsBGRA8: Cannot handle texture format 0x%08X",
+			texture->format);
+		return false;
+	}
+	uint32_t compressed_block_size = detexGetCompressedBlockSize(texture->format);
+	const uint8_t *data = texture->data + (size_t)first_block_row * texture->width_in_blocks *
+		compressed_block_size;
+	for (int y = first_block_row; y < first_block_row + nu_block_rows; y++) {
+		int nu_rows;
+		if (y * 4 + 3 >= texture->height)
+			nu_rows = texture->height - y * 4;
+		else
+			nu_rows = 4;
+		uint8_t *row_pixels = pixel_buffer + (size_t)(y - first_block_row) * 4 * row_pitch;
+		for (int x = 0; x < texture->width_in_blocks; x++) {
+			int nu_columns;
+			if (x * 4 + 3 >= texture->width)
+				nu_columns = texture->width - x * 4;
+			else
+				nu_columns = 4;
+			detexBlockChannels channels;
+			if (!DecodeBlockChannels(texture->format, data, flags, &channels))
+				return false;
+			StoreBlockBGRA8(&channels, row_pixels + x * 16, row_pitch, nu_columns, nu_rows);
+			data += compressed_block_size;
+		}
+	}
+	return true;
+}
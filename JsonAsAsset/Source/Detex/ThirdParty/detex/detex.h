@@ -52,7 +52,7 @@ __BEGIN_DECLS
 #elif defined(_MSC_VER)
 #define DETEX_INLINE_ONLY __inline
 #define DETEX_RESTRICT
-#define __thread
+#define __thread __declspec(thread)
 #endif
 
 /* Maximum uncompressed block size in bytes. */
@@ -388,6 +388,9 @@ enum {
 	/* return false (invalid block) when the compressed block is encoded */
 	/* using an opaque mode. */
 	DETEX_DECOMPRESS_FLAG_NON_OPAQUE_ONLY = 0x4,
+	/* For two component normal maps (BC5), reconstruct Z into the blue */
+	/* component (detexDecompressTextureRowsBGRA8 only). */
+	DETEX_DECOMPRESS_FLAG_NORMAL_Z = 0x8,
 };
 
 /* Set mode function flags. */
@@ -744,6 +747,22 @@ DETEX_API bool detexDecompressTextureTiled(const detexTexture *texture, uint8_t
 DETEX_API bool detexDecompressTextureLinear(const detexTexture *texture, uint8_t *pixel_buffer,
 	uint32_t pixel_format);
 
+/*
+ * Decode a range of block rows of a texture (linear), into a buffer that starts
+ * at the first decoded row. Disjoint ranges can be decoded from different threads.
+ */
+DETEX_API bool detexDecompressTextureLinearRows(const detexTexture *texture, uint8_t *pixel_buffer,
+	uint32_t pixel_format, int first_block_row, int nu_block_rows);
+
+/*
+ * Decode a range of block rows of a BC1, BC2, BC3, BC4 (RGTC1) or BC5 (RGTC2)
+ * texture straight into BGRA8 rows, row_pitch bytes apart, with vectorized
+ * kernels. The output matches NVTT's decoder: BC4 is stored as gray, BC5 in
+ * red and green (blue is the normal Z with DETEX_DECOMPRESS_FLAG_NORMAL_Z).
+ */
+DETEX_API bool detexDecompressTextureRowsBGRA8(const detexTexture *texture, uint8_t *pixel_buffer,
+	uint32_t row_pitch, int first_block_row, int nu_block_rows, uint32_t flags);
+
 
 /*
  * Miscellaneous functions.
@@ -758,6 +777,50 @@ DETEX_API bool detexConvertPixels(uint8_t *source_pixel_buffer, uint32_t nu_pixe
 	uint32_t source_pixel_format, uint8_t *target_pixel_buffer,
 	uint32_t target_pixel_format);
 
+/*
+ * Conversion between two pixel formats, resolved once with detexResolveConversion
+ * and reused for any number of pixel buffers (e.g. every block of a texture).
+ */
+typedef struct {
+	uint32_t source_pixel_format;
+	uint32_t target_pixel_format;
+	int nu_conversions;
+	uint32_t conversion[4];
+	int nu_non_in_place_conversions;
+	int first_non_in_place_conversion;
+	int last_non_in_place_conversion;
+} detexConversion;
+
+/* Largest pixel size in bytes of any pixel format. */
+#define DETEX_MAX_PIXEL_SIZE 16
+
+/* Scratch memory needed by detexConvertPixelsResolved to convert nu_pixels pixels. */
+#define DETEX_CONVERSION_SCRATCH_SIZE(nu_pixels) ((nu_pixels) * DETEX_MAX_PIXEL_SIZE * 3)
+
+/*
+ * Resolve the conversion steps between two pixel formats. Returns true if
+ * succesful.
+ */
+DETEX_API bool detexResolveConversion(uint32_t source_pixel_format, uint32_t target_pixel_format,
+	detexConversion *conversion);
+
+/*
+ * Convert pixels with a resolved conversion. Temporary buffers are taken from
+ * scratch_buffer (DETEX_CONVERSION_SCRATCH_SIZE(nu_pixels) bytes) instead of
+ * being allocated, unless it is NULL.
+ */
+DETEX_API bool detexConvertPixelsResolved(const detexConversion *conversion,
+	uint8_t *source_pixel_buffer, uint32_t nu_pixels, uint8_t *target_pixel_buffer,
+	uint8_t *scratch_buffer);
+
+/*
+ * Convert n half-floats to floats, and the other way around. Vectorized (F16C,
+ * or SSE2) where available.
+ */
+DETEX_API void detexConvertHalfFloatToFloat(uint16_t *source_buffer, int n, float *target_buffer);
+
+DETEX_API void detexConvertFloatToHalfFloat(float *source_buffer, int n, uint16_t *target_buffer);
+
 /* Convert in-place, modifying the source pixel buffer only. If any conversion step changes the */
 /* pixel size, the function will not be succesful and return false. */
 DETEX_API bool detexConvertPixelsInPlace(uint8_t * DETEX_RESTRICT source_pixel_buffer,
@@ -785,6 +848,67 @@ DETEX_API bool detexGetDX10Parameters(uint32_t texture_format, uint32_t *dx10_fo
 /* Return the error message for the last encountered error. */
 DETEX_API const char *detexGetErrorMessage();
 
+/*
+ * Reentrant decoding.
+ */
+
+typedef bool (*detexDecompressBlockFuncType)(const uint8_t *bitstring,
+	uint32_t mode_mask, uint32_t flags, uint8_t *pixel_buffer);
+
+/* Block decompress function and pixel conversion, resolved for a pair of formats. */
+typedef struct {
+	detexDecompressBlockFuncType decompress_func;
+	detexConversion conversion;
+} detexResolvedDecompressor;
+
+#define DETEX_CONTEXT_ERROR_MESSAGE_SIZE 256
+
+/*
+ * Decoding context. It holds what the decode functions otherwise keep per
+ * thread: the last error message, the resolved decompressor (reused as long as
+ * the formats stay the same) and the conversion scratch memory. Nothing is
+ * allocated, and nothing else is shared between calls, so any number of
+ * contexts can be used at once from different threads or tasks.
+ */
+typedef struct {
+	uint32_t texture_format;
+	uint32_t pixel_format;
+	detexResolvedDecompressor decompressor;
+	bool has_error;
+	char error_message[DETEX_CONTEXT_ERROR_MESSAGE_SIZE];
+	uint8_t scratch_buffer[DETEX_CONVERSION_SCRATCH_SIZE(16)];
+} detexContext;
+
+/* Initialize a decoding context before its first use. */
+DETEX_API void detexInitContext(detexContext *context);
+
+/*
+ * Decode texture function (linear) using the given context. Errors are recorded
+ * in the context instead of the thread's error message.
+ */
+DETEX_API bool detexDecompressTextureLinearWithContext(detexContext *context,
+	const detexTexture *texture, uint8_t *pixel_buffer, uint32_t pixel_format);
+
+/* Decode a range of block rows of a texture (linear) using the given context. */
+DETEX_API bool detexDecompressTextureLinearRowsWithContext(detexContext *context,
+	const detexTexture *texture, uint8_t *pixel_buffer, uint32_t pixel_format,
+	int first_block_row, int nu_block_rows);
+
+/* Return the error message of the last failed call with the context, or NULL. */
+DETEX_API const char *detexGetContextErrorMessage(const detexContext *context);
+
+typedef void *(*detexMallocFunc)(size_t size, void *user_data);
+typedef void (*detexFreeFunc)(void *ptr, void *user_data);
+
+/*
+ * Route the temporary buffers detex allocates (conversions that don't fit the
+ * scratch buffer) to another allocator, NULL functions restore malloc()/free().
+ * Textures returned by the loaders are still allocated with malloc(). Not
+ * thread-safe, set it before decoding anything.
+ */
+DETEX_API void detexSetAllocator(detexMallocFunc malloc_func, detexFreeFunc free_func,
+	void *user_data);
+
 
 /*
  * HDR-related functions.
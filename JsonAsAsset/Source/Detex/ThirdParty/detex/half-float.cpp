@@ -23,6 +23,7 @@ OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 //#include <fenv.h>
 
 #include "detex.h"
+#include "misc.h"
 
 /******************************************************************************
  *
@@ -77,9 +78,9 @@ OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  * - Otherwise, number is NaN (Not a Number)
  *
  * For the denormalized cases, note that 2^(-24) is the smallest number that can
- * be represented in half precision exactly. 2^(-25) will convert to 2^(-24)
- * because of the rounding algorithm used, and 2^(-26) is too small and underflows
- * to zero.
+ * be represented in half precision exactly. 2^(-25) is a tie and rounds to zero
+ * (to nearest even), anything above it converts to 2^(-24), and 2^(-26) is too
+ * small and underflows to zero.
  *
  ********************************************************************************/
 
@@ -161,14 +162,17 @@ void * DETEX_RESTRICT source, int numel)
                     } else {
                         xm |= 0x00800000u;  // Add the hidden leading bit
                         hm = (uint16_t) (xm >> (14 - hes)); // Mantissa
-                        if( (xm >> (13 - hes)) & 0x00000001u ) // Check for rounding
+                        // Round to nearest even, like the SIMD conversions
+                        if( ((xm >> (13 - hes)) & 0x00000001u) &&
+                            ((xm & ((1u << (13 - hes)) - 1u)) || (hm & 1u)) )
                             hm += (uint16_t) 1u; // Round, might overflow into exp bit, but this is OK
                     }
                     *hp++ = (hs | hm); // Combine sign bit and mantissa bits, biased exponent is zero
                 } else {
                     he = (uint16_t) (hes << 10); // Exponent
                     hm = (uint16_t) (xm >> 13); // Mantissa
-                    if( xm & 0x00001000u ) // Check for rounding
+                    // Round to nearest even, like the SIMD conversions
+                    if( (xm & 0x00001000u) && ((xm & 0x00000FFFu) || (hm & 1u)) )
                         *hp++ = (hs | he | hm) + (uint16_t) 1u; // Round, might overflow to inf, this is OK
                     else
                         *hp++ = (hs | he | hm);  // No rounding
@@ -266,16 +270,184 @@ void * DETEX_RESTRICT source, int numel)
 }
 
 
+#ifdef DETEX_USE_SSE2
+
+// Bulk conversions, the scalar routines above only handle the remainder.
+//
+// F16C is used when the CPU (and OS) support it, it is checked at run-time since
+// the library isn't compiled for AVX. Otherwise the branchless SSE2 versions below
+// (after Fabian Giesen's float/half conversions) are used. Both round to nearest
+// even when converting to half-float, and so does the scalar code.
+
+#if defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#define DETEX_TARGET_F16C
+#else
+#include <immintrin.h>
+#include <cpuid.h>
+#define DETEX_TARGET_F16C __attribute__((target("avx,f16c")))
+#endif
+
+static bool DetectF16C() {
+	uint32_t ecx;
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 1);
+	ecx = (uint32_t)info[2];
+#else
+	uint32_t eax, ebx, edx;
+	if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+		return false;
+#endif
+	// F16C, AVX and OSXSAVE, and the OS saving the YMM registers.
+	const uint32_t required = (1u << 29) | (1u << 28) | (1u << 27);
+	if ((ecx & required) != required)
+		return false;
+#if defined(_MSC_VER)
+	uint64_t xcr0 = _xgetbv(0);
+#else
+	uint32_t xcr0_lo, xcr0_hi;
+	__asm__ ("xgetbv" : "=a" (xcr0_lo), "=d" (xcr0_hi) : "c" (0));
+	uint64_t xcr0 = xcr0_lo | ((uint64_t)xcr0_hi << 32);
+#endif
+	return (xcr0 & 6) == 6;
+}
+
+static bool HasF16C() {
+	// Detected once, thread-safe (function-local static).
+	static const bool has_f16c = DetectF16C();
+	return has_f16c;
+}
+
+DETEX_TARGET_F16C static int ConvertHalfFloatToFloatF16C(const uint16_t * DETEX_RESTRICT source_buffer,
+int n, float * DETEX_RESTRICT target_buffer) {
+	int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m128i h = _mm_loadu_si128((const __m128i *)(source_buffer + i));
+		_mm_storeu_ps(target_buffer + i, _mm_cvtph_ps(h));
+		_mm_storeu_ps(target_buffer + i + 4, _mm_cvtph_ps(_mm_srli_si128(h, 8)));
+	}
+	return i;
+}
+
+DETEX_TARGET_F16C static int ConvertFloatToHalfFloatF16C(const float * DETEX_RESTRICT source_buffer,
+int n, uint16_t * DETEX_RESTRICT target_buffer) {
+	int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m128i lo = _mm_cvtps_ph(_mm_loadu_ps(source_buffer + i), _MM_FROUND_TO_NEAREST_INT);
+		__m128i hi = _mm_cvtps_ph(_mm_loadu_ps(source_buffer + i + 4), _MM_FROUND_TO_NEAREST_INT);
+		_mm_storeu_si128((__m128i *)(target_buffer + i), _mm_unpacklo_epi64(lo, hi));
+	}
+	return i;
+}
+
+// Four half-floats (zero-extended to 32 bits) to floats. Denormals are
+// normalized with a subtraction of normal floats, not a multiplication, which
+// would take the slow path for every float denormal.
+static DETEX_INLINE_ONLY __m128 HalfFloatToFloatSSE2(__m128i h) {
+	const __m128i mask_nosign = _mm_set1_epi32(0x7FFF);
+	const __m128i shifted_exp = _mm_set1_epi32(0x7C00 << 13);
+	const __m128i exp_adjust = _mm_set1_epi32((127 - 15) << 23);
+	const __m128i infnan_adjust = _mm_set1_epi32((128 - 16) << 23);
+	const __m128i denorm_adjust = _mm_set1_epi32(1 << 23);
+	const __m128 magic = _mm_castsi128_ps(_mm_set1_epi32(113 << 23));
+	__m128i expmant = _mm_and_si128(mask_nosign, h);
+	__m128i shifted = _mm_slli_epi32(expmant, 13);
+	__m128i exp = _mm_and_si128(shifted, shifted_exp);
+	__m128i o = _mm_add_epi32(shifted, exp_adjust);
+	// Inf and NaN keep an all ones exponent.
+	__m128i b_isinfnan = _mm_cmpeq_epi32(exp, shifted_exp);
+	o = _mm_add_epi32(o, _mm_and_si128(b_isinfnan, infnan_adjust));
+	__m128i b_isdenorm = _mm_cmpeq_epi32(exp, _mm_setzero_si128());
+	__m128i denorm = _mm_castps_si128(_mm_sub_ps(
+		_mm_castsi128_ps(_mm_add_epi32(o, denorm_adjust)), magic));
+	o = _mm_or_si128(_mm_and_si128(b_isdenorm, denorm), _mm_andnot_si128(b_isdenorm, o));
+	__m128i sign = _mm_slli_epi32(_mm_xor_si128(h, expmant), 16);
+	return _mm_castsi128_ps(_mm_or_si128(o, sign));
+}
+
+// Four floats to half-floats, returned sign-extended to 32 bits so they can be
+// narrowed with _mm_packs_epi32.
+static DETEX_INLINE_ONLY __m128i FloatToHalfFloatSSE2(__m128 f) {
+	const __m128i mask_sign = _mm_set1_epi32(0x80000000u);
+	const __m128i f16max = _mm_set1_epi32((127 + 16) << 23);
+	const __m128i nanbit = _mm_set1_epi32(0x200);
+	const __m128i infty_as_fp16 = _mm_set1_epi32(0x7C00);
+	const __m128i min_normal = _mm_set1_epi32((127 - 14) << 23);
+	const __m128i subnorm_magic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+	const __m128i normal_bias = _mm_set1_epi32(0xFFF - ((127 - 15) << 23));
+	__m128 justsign = _mm_and_ps(_mm_castsi128_ps(mask_sign), f);
+	__m128 absf = _mm_xor_ps(f, justsign);
+	__m128i absf_int = _mm_castps_si128(absf);
+	__m128 b_isnan = _mm_cmpunord_ps(absf, absf);
+	__m128i b_isregular = _mm_cmpgt_epi32(f16max, absf_int);
+	__m128i inf_or_nan = _mm_or_si128(_mm_and_si128(_mm_castps_si128(b_isnan), nanbit),
+		infty_as_fp16);
+	__m128i b_issub = _mm_cmpgt_epi32(min_normal, absf_int);
+	// Denormal result, the addition rounds the mantissa.
+	__m128 subnorm1 = _mm_add_ps(absf, _mm_castsi128_ps(subnorm_magic));
+	__m128i subnorm2 = _mm_sub_epi32(_mm_castps_si128(subnorm1), subnorm_magic);
+	// Normal result, rebias and round to nearest even.
+	__m128i mantodd = _mm_srai_epi32(_mm_slli_epi32(absf_int, 31 - 13), 31);
+	__m128i round = _mm_sub_epi32(_mm_add_epi32(absf_int, normal_bias), mantodd);
+	__m128i normal = _mm_srli_epi32(round, 13);
+	__m128i nonspecial = _mm_or_si128(_mm_and_si128(subnorm2, b_issub),
+		_mm_andnot_si128(b_issub, normal));
+	__m128i joined = _mm_or_si128(_mm_and_si128(nonspecial, b_isregular),
+		_mm_andnot_si128(b_isregular, inf_or_nan));
+	return _mm_or_si128(joined, _mm_srai_epi32(_mm_castps_si128(justsign), 16));
+}
+
+static int ConvertHalfFloatToFloatSSE2(const uint16_t * DETEX_RESTRICT source_buffer,
+int n, float * DETEX_RESTRICT target_buffer) {
+	const __m128i zero = _mm_setzero_si128();
+	int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m128i h = _mm_loadu_si128((const __m128i *)(source_buffer + i));
+		_mm_storeu_ps(target_buffer + i, HalfFloatToFloatSSE2(_mm_unpacklo_epi16(h, zero)));
+		_mm_storeu_ps(target_buffer + i + 4, HalfFloatToFloatSSE2(_mm_unpackhi_epi16(h, zero)));
+	}
+	return i;
+}
+
+static int ConvertFloatToHalfFloatSSE2(const float * DETEX_RESTRICT source_buffer,
+int n, uint16_t * DETEX_RESTRICT target_buffer) {
+	int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m128i lo = FloatToHalfFloatSSE2(_mm_loadu_ps(source_buffer + i));
+		__m128i hi = FloatToHalfFloatSSE2(_mm_loadu_ps(source_buffer + i + 4));
+		_mm_storeu_si128((__m128i *)(target_buffer + i), _mm_packs_epi32(lo, hi));
+	}
+	return i;
+}
+
+#endif
+
 // Conversion functions.
 void detexConvertHalfFloatToFloat(uint16_t *source_buffer, int n, float *target_buffer) {
-    halfp2singles(target_buffer, source_buffer, n);
+	int i = 0;
+#ifdef DETEX_USE_SSE2
+	if (HasF16C())
+		i = ConvertHalfFloatToFloatF16C(source_buffer, n, target_buffer);
+	else
+		i = ConvertHalfFloatToFloatSSE2(source_buffer, n, target_buffer);
+#endif
+	halfp2singles(target_buffer + i, source_buffer + i, n - i);
 }
 
-#if 0
 void detexConvertFloatToHalfFloat(float *source_buffer, int n, uint16_t *target_buffer) {
-	singles2halfp(target_buffer, source_buffer, n);
+	int i = 0;
+#ifdef DETEX_USE_SSE2
+	if (HasF16C())
+		i = ConvertFloatToHalfFloatF16C(source_buffer, n, target_buffer);
+	else
+		i = ConvertFloatToHalfFloatSSE2(source_buffer, n, target_buffer);
+#endif
+	singles2halfp(target_buffer + i, source_buffer + i, n - i);
 }
 
+#if 0
 // Convert normalized half floats to unsigned 16-bit integers in place.
 void detexConvertNormalizedHalfFloatToUInt16(uint16_t *buffer, int n) {
 	fesetround(FE_DOWNWARD);
@@ -18,14 +18,21 @@ OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 
 #pragma once
 
-void detexConvertHalfFloatToFloat(uint16_t *source_buffer, int n, float *target_buffer);
+#include "detex.h"
 
-void detexConvertFloatToHalfFloat(float *source_buffer, int n, uint16_t *target_buffer);
+/* Same linkage as the declarations in detex.h. */
+__BEGIN_DECLS
+
+DETEX_API void detexConvertHalfFloatToFloat(uint16_t *source_buffer, int n, float *target_buffer);
+
+DETEX_API void detexConvertFloatToHalfFloat(float *source_buffer, int n, uint16_t *target_buffer);
 
 void detexConvertNormalizedHalfFloatToUInt16(uint16_t *buffer, int n);
 
 void detexConvertNormalizedFloatToUInt16(float *source_buffer, int n, uint16_t *target_buffer);
 
+__END_DECLS
+
 static DETEX_INLINE_ONLY float detexGetFloatFromHalfFloat(uint16_t hf) {
     float result = 0.0f;
     detexConvertHalfFloatToFloat(&hf, 1, &result);
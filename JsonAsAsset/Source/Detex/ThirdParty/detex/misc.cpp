@@ -75,15 +75,56 @@ end:
 	return true;
 }
 
+// Allocation.
+
+static detexMallocFunc detex_malloc_func = NULL;
+static detexFreeFunc detex_free_func = NULL;
+static void *detex_allocator_user_data = NULL;
+
+void detexSetAllocator(detexMallocFunc malloc_func, detexFreeFunc free_func, void *user_data) {
+	bool custom = malloc_func != NULL && free_func != NULL;
+	detex_malloc_func = custom ? malloc_func : NULL;
+	detex_free_func = custom ? free_func : NULL;
+	detex_allocator_user_data = custom ? user_data : NULL;
+}
+
+void *detexMalloc(size_t size) {
+	if (detex_malloc_func != NULL)
+		return detex_malloc_func(size, detex_allocator_user_data);
+	return malloc(size);
+}
+
+void detexFree(void *ptr) {
+	if (detex_free_func != NULL)
+		detex_free_func(ptr, detex_allocator_user_data);
+	else
+		free(ptr);
+}
+
 // Error handling.
 
 static __thread char *detex_error_message = NULL;
+static __thread detexContext *detex_current_context = NULL;
+
+detexContext *detexSetCurrentContext(detexContext *context) {
+	detexContext *previous_context = detex_current_context;
+	detex_current_context = context;
+	return previous_context;
+}
 
 void detexSetErrorMessage(const char *format, ...) {
-	if (detex_error_message != NULL)
-		free(detex_error_message);
 	va_list args;
 	va_start(args, format);
+	if (detex_current_context != NULL) {
+		// Errors during a call with a context stay in it, truncated if needed.
+		vsnprintf(detex_current_context->error_message, DETEX_CONTEXT_ERROR_MESSAGE_SIZE,
+			format, args);
+		detex_current_context->has_error = true;
+		va_end(args);
+		return;
+	}
+	if (detex_error_message != NULL)
+		free(detex_error_message);
 	char *message;
 	// Allocate and set message.
 #ifdef __GNUC__
@@ -105,6 +146,10 @@ void detexSetErrorMessage(const char *format, ...) {
 const char *detexGetErrorMessage() {
 	return detex_error_message;
 }
+
+const char *detexGetContextErrorMessage(const detexContext *context) {
+	return context->has_error ? context->error_message : NULL;
+}
 /*
 // General texture file loading.
 
@@ -18,5 +18,24 @@ OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 
 #pragma once
 
+#include "detex.h"
+
+/* SSE2 is always available on x64 (and NEON on arm64), kernels fall back to scalar code elsewhere. */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DETEX_USE_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define DETEX_USE_NEON
+#include <arm_neon.h>
+#endif
+
 void detexSetErrorMessage(const char *format, ...);
 
+// Temporary allocations, through the allocator set with detexSetAllocator().
+void *detexMalloc(size_t size);
+void detexFree(void *ptr);
+
+// Route error messages of the calling thread to a context (NULL to restore the
+// thread's own error message), returns the previous context.
+detexContext *detexSetCurrentContext(detexContext *context);
+
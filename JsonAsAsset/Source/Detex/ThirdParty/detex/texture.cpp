@@ -21,9 +21,6 @@ OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 #include "detex.h"
 #include "misc.h"
 
-typedef bool (*detexDecompressBlockFuncType)(const uint8_t *bitstring,
-	uint32_t mode_mask, uint32_t flags, uint8_t *pixel_buffer);
-
 static detexDecompressBlockFuncType decompress_function[] = {
 	NULL,
 	NULL, // detexDecompressBlockBC1,
@@ -41,9 +38,9 @@ static detexDecompressBlockFuncType decompress_function[] = {
 	detexDecompressBlockETC2,
 	detexDecompressBlockETC2_PUNCHTHROUGH,
 	detexDecompressBlockETC2_EAC,
-	NULL, // detexDecompressBlockEAC_R11,
+	detexDecompressBlockEAC_R11,
 	NULL, // detexDecompressBlockEAC_SIGNED_R11,
-	NULL, // detexDecompressBlockEAC_RG11,
+	detexDecompressBlockEAC_RG11,
 	NULL, // detexDecompressBlockEAC_SIGNED_RG11,
 };
 
@@ -69,6 +66,38 @@ uint32_t pixel_format) {
 		detexGetPixelFormat(texture_format), pixel_buffer, pixel_format);
 }
 
+/*
+ * Block decompressor resolved once for a whole texture: the decompress function
+ * is looked up and the pixel conversion is resolved a single time, instead of
+ * once per block.
+ */
+static bool ResolveDecompressor(uint32_t texture_format, uint32_t pixel_format,
+detexResolvedDecompressor *decompressor) {
+	decompressor->decompress_func =
+		decompress_function[detexGetCompressedFormat(texture_format)];
+	if (decompressor->decompress_func == NULL) {
+		detexSetErrorMessage("Decompression of texture format 0x%08X is not supported",
+			texture_format);
+		return false;
+	}
+	return detexResolveConversion(detexGetPixelFormat(texture_format), pixel_format,
+		&decompressor->conversion);
+}
+
+static DETEX_INLINE_ONLY bool DecompressBlockResolved(const detexResolvedDecompressor *decompressor,
+const uint8_t * DETEX_RESTRICT bitstring, uint8_t * DETEX_RESTRICT pixel_buffer,
+uint8_t *scratch_buffer) {
+	// Without any conversion, the block is decompressed straight into the target.
+	if (decompressor->conversion.nu_conversions == 0)
+		return decompressor->decompress_func(bitstring, DETEX_MODE_MASK_ALL, 0,
+			pixel_buffer);
+	uint8_t block_buffer[DETEX_MAX_BLOCK_SIZE];
+	if (!decompressor->decompress_func(bitstring, DETEX_MODE_MASK_ALL, 0, block_buffer))
+		return false;
+	return detexConvertPixelsResolved(&decompressor->conversion, block_buffer, 16,
+		pixel_buffer, scratch_buffer);
+}
+
 /*
  * Decode texture function (tiled). Decode an entire compressed texture into an
  * array of image buffer tiles (corresponding to compressed blocks), converting
@@ -80,18 +109,23 @@ uint8_t * DETEX_RESTRICT pixel_buffer, uint32_t pixel_format) {
 		detexSetErrorMessage("detexDecompressTextureTiled: Cannot handle uncompressed texture format");
 		return false;
 	}
+	detexResolvedDecompressor decompressor;
+	if (!ResolveDecompressor(texture->format, pixel_format, &decompressor))
+		return false;
+	uint8_t scratch_buffer[DETEX_CONVERSION_SCRATCH_SIZE(16)];
 	const uint8_t *data = texture->data;
+	uint32_t compressed_block_size = detexGetCompressedBlockSize(texture->format);
+	uint32_t block_size = detexGetPixelSize(pixel_format) * 16;
 	bool result = true;
 	for (int y = 0; y < texture->height_in_blocks; y++)
 		for (int x = 0; x < texture->width_in_blocks; x++) {
-			bool r = detexDecompressBlock(data, texture->format,
-				DETEX_MODE_MASK_ALL, 0, pixel_buffer, pixel_format);
-			uint32_t block_size = detexGetPixelSize(pixel_format) * 16;
+			bool r = DecompressBlockResolved(&decompressor, data, pixel_buffer,
+				scratch_buffer);
 			if (!r) {
 				result = false;
 				memset(pixel_buffer, 0, block_size);
 			}
-			data += detexGetCompressedBlockSize(texture->format);
+			data += compressed_block_size;
 			pixel_buffer += block_size;
 		}
 	return result;
@@ -104,30 +138,39 @@ uint8_t * DETEX_RESTRICT pixel_buffer, uint32_t pixel_format) {
  */
 bool detexDecompressTextureLinear(const detexTexture *texture,
 uint8_t * DETEX_RESTRICT pixel_buffer, uint32_t pixel_format) {
-	uint8_t block_buffer[DETEX_MAX_BLOCK_SIZE];
 	if (!detexFormatIsCompressed(texture->format)) {
 		return detexConvertPixels(texture->data, texture->width * texture->height,
 			detexGetPixelFormat(texture->format), pixel_buffer, pixel_format);
 	}
-	const uint8_t *data = texture->data;
-	int pixel_size = detexGetPixelSize(pixel_format);
+	return detexDecompressTextureLinearRows(texture, pixel_buffer, pixel_format,
+		0, texture->height_in_blocks);
+}
+
+// Decode a range of block rows with a resolved decompressor.
+static bool DecompressRows(const detexResolvedDecompressor *decompressor,
+const detexTexture *texture, uint8_t * DETEX_RESTRICT pixel_buffer, int pixel_size,
+int first_block_row, int nu_block_rows, uint8_t *scratch_buffer) {
+	uint8_t block_buffer[DETEX_MAX_BLOCK_SIZE];
+	uint32_t compressed_block_size = detexGetCompressedBlockSize(texture->format);
+	const uint8_t *data = texture->data + (size_t)first_block_row * texture->width_in_blocks *
+		compressed_block_size;
+	uint32_t block_size = pixel_size * 16;
 	bool result = true;
-	for (int y = 0; y < texture->height_in_blocks; y++) {
+	for (int y = first_block_row; y < first_block_row + nu_block_rows; y++) {
 		int nu_rows;
 		if (y * 4 + 3 >= texture->height)
 			nu_rows = texture->height - y * 4;
 		else
 			nu_rows = 4;
 		for (int x = 0; x < texture->width_in_blocks; x++) {
-			bool r = detexDecompressBlock(data, texture->format,
-				DETEX_MODE_MASK_ALL, 0, block_buffer, pixel_format);
-			uint32_t block_size = detexGetPixelSize(pixel_format) * 16;
+			bool r = DecompressBlockResolved(decompressor, data, block_buffer,
+				scratch_buffer);
 			if (!r) {
 				result = false;
 				memset(block_buffer, 0, block_size);
 			}
 			uint8_t *pixelp = pixel_buffer +
-				y * 4 * texture->width * pixel_size +
+				(size_t)(y - first_block_row) * 4 * texture->width * pixel_size +
 				+ x * 4 * pixel_size;
 			int nu_columns;
 			if (x * 4 + 3  >= texture->width)
@@ -138,8 +181,83 @@ uint8_t * DETEX_RESTRICT pixel_buffer, uint32_t pixel_format) {
 				memcpy(pixelp + row * texture->width * pixel_size,
 					block_buffer + row * 4 * pixel_size,
 					nu_columns * pixel_size);
-			data += detexGetCompressedBlockSize(texture->format);
+			data += compressed_block_size;
 		}
 	}
 	return result;
 }
+
+/*
+ * Decode a range of block rows of a texture (linear). Only the block rows
+ * [first_block_row, first_block_row + nu_block_rows) are decoded, the first
+ * decoded pixel row is stored at the start of the pixel buffer. Disjoint
+ * ranges can be decoded from different threads at the same time.
+ */
+bool detexDecompressTextureLinearRows(const detexTexture *texture,
+uint8_t * DETEX_RESTRICT pixel_buffer, uint32_t pixel_format, int first_block_row,
+int nu_block_rows) {
+	uint8_t scratch_buffer[DETEX_CONVERSION_SCRATCH_SIZE(16)];
+	if (!detexFormatIsCompressed(texture->format)) {
+		detexSetErrorMessage("detexDecompressTextureLinearRows: Cannot handle uncompressed texture format");
+		return false;
+	}
+	detexResolvedDecompressor decompressor;
+	if (!ResolveDecompressor(texture->format, pixel_format, &decompressor))
+		return false;
+	return DecompressRows(&decompressor, texture, pixel_buffer, detexGetPixelSize(pixel_format),
+		first_block_row, nu_block_rows, scratch_buffer);
+}
+
+/*
+ * Reentrant decoding.
+ */
+
+void detexInitContext(detexContext *context) {
+	context->texture_format = 0;
+	context->pixel_format = 0;
+	context->has_error = false;
+	context->error_message[0] = '\0';
+}
+
+bool detexDecompressTextureLinearRowsWithContext(detexContext *context,
+const detexTexture *texture, uint8_t * DETEX_RESTRICT pixel_buffer, uint32_t pixel_format,
+int first_block_row, int nu_block_rows) {
+	detexContext *previous_context = detexSetCurrentContext(context);
+	context->has_error = false;
+	bool result = false;
+	if (!detexFormatIsCompressed(texture->format)) {
+		detexSetErrorMessage("detexDecompressTextureLinearRows: Cannot handle uncompressed texture format");
+	}
+	else if (context->texture_format == texture->format && context->pixel_format == pixel_format) {
+		result = true;
+	}
+	else if (ResolveDecompressor(texture->format, pixel_format, &context->decompressor)) {
+		context->texture_format = texture->format;
+		context->pixel_format = pixel_format;
+		result = true;
+	}
+	else {
+		// Nothing valid to reuse next time.
+		context->texture_format = 0;
+	}
+	if (result)
+		result = DecompressRows(&context->decompressor, texture, pixel_buffer,
+			detexGetPixelSize(pixel_format), first_block_row, nu_block_rows,
+			context->scratch_buffer);
+	detexSetCurrentContext(previous_context);
+	return result;
+}
+
+bool detexDecompressTextureLinearWithContext(detexContext *context,
+const detexTexture *texture, uint8_t * DETEX_RESTRICT pixel_buffer, uint32_t pixel_format) {
+	if (!detexFormatIsCompressed(texture->format)) {
+		detexContext *previous_context = detexSetCurrentContext(context);
+		context->has_error = false;
+		bool result = detexConvertPixels(texture->data, texture->width * texture->height,
+			detexGetPixelFormat(texture->format), pixel_buffer, pixel_format);
+		detexSetCurrentContext(previous_context);
+		return result;
+	}
+	return detexDecompressTextureLinearRowsWithContext(context, texture, pixel_buffer,
+		pixel_format, 0, texture->height_in_blocks);
+}
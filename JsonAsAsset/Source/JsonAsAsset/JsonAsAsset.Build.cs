@@ -43,7 +43,8 @@ public class JsonAsAsset : ModuleRules
 			"PluginUtils",
 			"RHI",
 			"Detex",
-			"NVTT"
+			"NVTT",
+			"ImageWrapper"
 		});
 	}
 }
\ No newline at end of file
@@ -17,9 +17,6 @@
 bool UCurveLinearColorAtlasImporter::ImportData() {
 	try {
 		TSharedPtr<FJsonObject> Properties = JsonObject->GetObjectField("Properties");
-		
-		// Create UTextureImporters to add UTexture2D properties
-		const UTextureImporter* Importer = new UTextureImporter(FString(), FString(), JsonObject, Package, OutermostPkg);
 
 		float Width = 256;
 		float Height = 256;
@@ -5,6 +5,7 @@
 #include "Dom/JsonObject.h"
 #include "Factories/CurveTableFactory.h"
 #include "Utilities/AssetUtilities.h"
+#include "Utilities/EnumUtilities.h"
 
 bool UCurveTableImporter::ImportData() {
 	try {
@@ -15,7 +16,7 @@ bool UCurveTableImporter::ImportData() {
 		// Used to determine curve type
 		ECurveTableMode CurveTableMode = ECurveTableMode::RichCurves; {
 			if (FString CurveMode; JsonObject->TryGetStringField("CurveTableMode", CurveMode))
-				CurveTableMode = static_cast<ECurveTableMode>(StaticEnum<ECurveTableMode>()->GetValueByNameString(CurveMode));
+				CurveTableMode = FEnumUtilities::GetValue<ECurveTableMode>(CurveMode);
 
 			DerivedCurveTable->ChangeTableMode(CurveTableMode);
 		}
@@ -39,17 +40,11 @@ bool UCurveTableImporter::ImportData() {
 							FRichCurveKey RichKey = NewRichCurve.Keys.Last();
 
 							RichKey.InterpMode =
-								static_cast<ERichCurveInterpMode>(
-									StaticEnum<ERichCurveInterpMode>()->GetValueByNameString(Key->GetStringField("InterpMode"))
-								);
+								FEnumUtilities::GetValue<ERichCurveInterpMode>(Key->GetStringField("InterpMode"));
 							RichKey.TangentMode =
-								static_cast<ERichCurveTangentMode>(
-									StaticEnum<ERichCurveTangentMode>()->GetValueByNameString(Key->GetStringField("TangentMode"))
-								);
+								FEnumUtilities::GetValue<ERichCurveTangentMode>(Key->GetStringField("TangentMode"));
 							RichKey.TangentWeightMode =
-								static_cast<ERichCurveTangentWeightMode>(
-									StaticEnum<ERichCurveTangentWeightMode>()->GetValueByNameString(Key->GetStringField("TangentWeightMode"))
-								);
+								FEnumUtilities::GetValue<ERichCurveTangentWeightMode>(Key->GetStringField("TangentWeightMode"));
 
 							RichKey.ArriveTangent = Key->GetNumberField("ArriveTangent");
 							RichKey.ArriveTangentWeight = Key->GetNumberField("ArriveTangentWeight");
@@ -64,9 +59,7 @@ bool UCurveTableImporter::ImportData() {
 
 				// Method of Interpolation
 				NewSimpleCurve.InterpMode =
-					static_cast<ERichCurveInterpMode>(
-						StaticEnum<ERichCurveInterpMode>()->GetValueByNameString(CurveData->GetStringField("InterpMode"))
-					);
+					FEnumUtilities::GetValue<ERichCurveInterpMode>(CurveData->GetStringField("InterpMode"));
 
 				if (const TArray<TSharedPtr<FJsonValue>>* KeysPtr; CurveData->TryGetArrayField("Keys", KeysPtr))
 					for (const TSharedPtr<FJsonValue> KeyPtr : *KeysPtr) {
@@ -79,13 +72,9 @@ bool UCurveTableImporter::ImportData() {
 			// Inherited data from FRealCurve
 			RealCurve.SetDefaultValue(CurveData->GetNumberField("DefaultValue"));
 			RealCurve.PreInfinityExtrap = 
-				static_cast<ERichCurveExtrapolation>(
-					StaticEnum<ERichCurveExtrapolation>()->GetValueByNameString(CurveData->GetStringField("PreInfinityExtrap"))
-				);
+				FEnumUtilities::GetValue<ERichCurveExtrapolation>(CurveData->GetStringField("PreInfinityExtrap"));
 			RealCurve.PostInfinityExtrap =
-				static_cast<ERichCurveExtrapolation>(
-					StaticEnum<ERichCurveExtrapolation>()->GetValueByNameString(CurveData->GetStringField("PostInfinityExtrap"))
-				);
+				FEnumUtilities::GetValue<ERichCurveExtrapolation>(CurveData->GetStringField("PostInfinityExtrap"));
 
 			// Update Curve Table
 			CurveTable->OnCurveTableChanged().Broadcast();
@@ -2,6 +2,7 @@
 
 #include "Importers/DataTableImporter.h"
 
+#include "Async/ParallelFor.h"
 #include "Dom/JsonObject.h"
 #include "Utilities/AssetUtilities.h"
 
@@ -34,14 +35,49 @@ bool UDataTableImporter::ImportData() {
 		UPropertySerializer* ObjectPropertySerializer = GetObjectSerializer()->GetPropertySerializer();
 		TSharedPtr<FJsonObject> RowData = JsonObject->GetObjectField("Rows");
 
-		// Loop throughout row data, and deserialize
+		TArray<FName> RowNames;
+		TArray<TSharedPtr<FJsonObject>> RowValues;
+		TArray<TSharedPtr<FStructOnScope>> ScopedStructs;
+
+		RowNames.Reserve(RowData->Values.Num());
+		RowValues.Reserve(RowData->Values.Num());
+		ScopedStructs.Reserve(RowData->Values.Num());
+
 		for (TPair<FString, TSharedPtr<FJsonValue>>& Pair : RowData->Values) {
-			TSharedPtr<FStructOnScope> ScopedStruct = MakeShareable(new FStructOnScope(TableRowStruct));
-			TSharedPtr<FJsonObject> StructData = Pair.Value->AsObject();
+			RowNames.Add(*Pair.Key);
+			RowValues.Add(Pair.Value->AsObject());
+			ScopedStructs.Add(MakeShareable(new FStructOnScope(TableRowStruct)));
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+
+		// Rows are filled by workers, object references are left as fixups and loaded here afterwards
+		if (UPropertySerializer::CanDeserializeStructDeferred(TableRowStruct)) {
+			TArray<TArray<FPropertyFixup>> RowFixups;
+			RowFixups.SetNum(RowNames.Num());
+
+			ParallelFor(RowNames.Num(), [&](const int32 Index) {
+				ObjectPropertySerializer->DeserializeStructDeferred(TableRowStruct, RowValues[Index].ToSharedRef(), ScopedStructs[Index]->GetStructMemory(), RowFixups[Index]);
+			});
+
+			int32 NumFixups = 0;
+			for (const TArray<FPropertyFixup>& Fixups : RowFixups) {
+				ObjectPropertySerializer->ResolveFixups(Fixups);
+				NumFixups += Fixups.Num();
+			}
+
+			UE_LOG(LogJson, Log, TEXT("Deserialized %d rows of %s in %.2f ms (%d object references)"), RowNames.Num(), *FileName, (FPlatformTime::Seconds() - StartTime) * 1000.0, NumFixups);
+		} else {
+			for (int32 Index = 0; Index < RowNames.Num(); Index++) {
+				ObjectPropertySerializer->DeserializeStruct(TableRowStruct, RowValues[Index].ToSharedRef(), ScopedStructs[Index]->GetStructMemory());
+			}
+
+			UE_LOG(LogJson, Log, TEXT("Deserialized %d rows of %s in %.2f ms (on the game thread, %s holds object references in sets or maps)"), RowNames.Num(), *FileName, (FPlatformTime::Seconds() - StartTime) * 1000.0, *TableRowStruct->GetName());
+		}
 
-			// Deserialize, add row
-			ObjectPropertySerializer->DeserializeStruct(TableRowStruct, StructData.ToSharedRef(), ScopedStruct->GetStructMemory());
-			DataTable->AddRow(*Pair.Key, *(const FTableRowBase*)ScopedStruct->GetStructMemory());
+		// Add rows, in the order of the json
+		for (int32 Index = 0; Index < RowNames.Num(); Index++) {
+			DataTable->AddRow(RowNames[Index], *(const FTableRowBase*)ScopedStructs[Index]->GetStructMemory());
 		}
 
 		// Handle edit changes, and add it to the content browser
@@ -35,6 +35,9 @@
 // <---- Importers
 
 #include "Utilities/AssetUtilities.h"
+#include "Utilities/ClassUtilities.h"
+#include "Utilities/PrefetchUtilities.h"
+#include "Utilities/ImportJob.h"
 #include "Widgets/Notifications/SNotificationList.h"
 #include "Framework/Notifications/NotificationManager.h"
 #include "Importers/CurveTableImporter.h"
@@ -158,19 +161,24 @@ TArray<TObjectPtr<T>> IImporter::LoadObject(const TArray<TSharedPtr<FJsonValue>>
 	return Array;
 }
 
-bool IImporter::HandleReference(const FString& GamePath) {
+FString IImporter::GetReferenceFile(const FString& File, const FString& GamePath) {
 	const UJsonAsAssetSettings* Settings = GetDefault<UJsonAsAssetSettings>();
 
 	FString UnSanitizedCodeName;
-	FilePath.Split(Settings->ExportDirectory.Path + "/", nullptr, &UnSanitizedCodeName);
+	File.Split(Settings->ExportDirectory.Path + "/", nullptr, &UnSanitizedCodeName);
 	UnSanitizedCodeName.Split("/", &UnSanitizedCodeName, nullptr, ESearchCase::IgnoreCase, ESearchDir::FromStart);
 
 	// TODO: As of writing this, I don't know how to add Plugin support
 	FString UnSanitizedPath = GamePath.Replace(TEXT("/Game/"), *(UnSanitizedCodeName + "/Content/"));
-	UnSanitizedPath = Settings->ExportDirectory.Path + "/" + UnSanitizedPath + ".json";
 
-	FString ContentBefore;
-	if (FFileHelper::LoadFileToString(ContentBefore, *UnSanitizedPath)) {
+	return Settings->ExportDirectory.Path + "/" + UnSanitizedPath + ".json";
+}
+
+bool IImporter::HandleReference(const FString& GamePath) {
+	// Full path, the same key PrefetchReferences prefetched it under
+	const FString UnSanitizedPath = GetReferenceFile(FPaths::ConvertRelativePathToFull(FilePath), GamePath);
+
+	if (FPaths::FileExists(UnSanitizedPath)) {
 		ImportReference(UnSanitizedPath);
 
 		return true;
@@ -180,31 +188,90 @@ bool IImporter::HandleReference(const FString& GamePath) {
 }
 
 void IImporter::ImportReference(const FString& File) {
-	/* ----  Parse JSON into UE JSON Reader ---- */
-	FString ContentBefore;
-	FFileHelper::LoadFileToString(ContentBefore, *File);
-
-	FString Content = FString(TEXT("{\"data\": "));
-	Content.Append(ContentBefore);
-	Content.Append(FString("}"));
-
 	TSharedPtr<FJsonObject> JsonParsed;
-	const TSharedRef<TJsonReader<TCHAR>> JsonReader = TJsonReaderFactory<TCHAR>::Create(Content);
-	/* ---------------------------------------- */
+	if (!FPrefetchUtilities::TakeFile(File, JsonParsed))
+		JsonParsed = FPrefetchUtilities::LoadReferenceFile(File);
 
-	if (FJsonSerializer::Deserialize(JsonReader, JsonParsed)) {
+	if (JsonParsed.IsValid()) {
 		const TArray<TSharedPtr<FJsonValue>> DataObjects = JsonParsed->GetArrayField("data");
 
 		HandleExports(DataObjects, File);
 	}
 }
 
+void IImporter::PrefetchReferences(const TArray<TSharedPtr<FJsonValue>>& Exports, const FString& File) {
+	const UJsonAsAssetSettings* Settings = GetDefault<UJsonAsAssetSettings>();
+	if (!Settings->bPrefetchReferences)
+		return;
+
+	const FString SelfName = FPaths::GetBaseFilename(File);
+	TSet<FString> Visited;
+
+	// Walk every value, package indexes are objects with "ObjectName" and "ObjectPath"
+	TArray<TSharedPtr<FJsonValue>> Stack = Exports;
+	while (!Stack.IsEmpty()) {
+		const TSharedPtr<FJsonValue> Value = Stack.Pop(false);
+		if (!Value.IsValid())
+			continue;
+
+		if (Value->Type == EJson::Array) {
+			Stack.Append(Value->AsArray());
+			continue;
+		}
+
+		if (Value->Type != EJson::Object)
+			continue;
+
+		const TSharedPtr<FJsonObject> Object = Value->AsObject();
+		for (const TPair<FString, TSharedPtr<FJsonValue>>& Field : Object->Values)
+			if (Field.Value.IsValid() && (Field.Value->Type == EJson::Object || Field.Value->Type == EJson::Array))
+				Stack.Add(Field.Value);
+
+		FString ObjectName, ObjectPath;
+		if (!Object->TryGetStringField("ObjectName", ObjectName) || !Object->TryGetStringField("ObjectPath", ObjectPath))
+			continue;
+
+		FString Type;
+		FString Name;
+		ObjectName.Split("'", &Type, &Name);
+		FString Path;
+		ObjectPath.Split(".", &Path, nullptr);
+
+		Path = Path.Replace(TEXT("FortniteGame/Content"), TEXT("/Game"));
+		Path = Path.Replace(TEXT("Engine/Content"), TEXT("/Engine"));
+
+		Name = Name.Replace(TEXT("'"), TEXT(""));
+
+		// Subobjects, classes and the asset itself are never fetched
+		if (Path.IsEmpty() || Name.Contains(":") || Path.StartsWith("/Script/") || FPaths::GetBaseFilename(Path) == SelfName)
+			continue;
+
+		const FString AssetPath = Path + "." + Name;
+		if (Visited.Contains(AssetPath))
+			continue;
+
+		Visited.Add(AssetPath);
+
+		if (FindObject<UObject>(nullptr, *AssetPath) != nullptr || FPackageName::DoesPackageExist(Path))
+			continue;
+
+		// Disk probe first, only ask Local Fetch if it isn't exported locally
+		if (const FString ReferenceFile = GetReferenceFile(File, Path); FPaths::FileExists(ReferenceFile)) {
+			FPrefetchUtilities::PrefetchFile(ReferenceFile);
+		} else if (Settings->bEnableLocalFetch && FAssetUtilities::CanConstructAsset(Type)) {
+			FPrefetchUtilities::PrefetchRequest(Settings->Url + "/api/v1/export?raw=true&path=" + AssetPath);
+
+			if (Type == "Texture2D" || Type == "TextureCube" || Type == "VolumeTexture" || Type == "Texture2DArray")
+				FPrefetchUtilities::PrefetchRequest(Settings->Url + "/api/v1/export?path=" + AssetPath, "application/octet-stream");
+		}
+	}
+}
+
 bool IImporter::HandleAssetCreation(UObject* Asset) const {
 	FAssetRegistryModule::AssetCreated(Asset);
 	if (!Asset->MarkPackageDirty()) return false;
 	Package->SetDirtyFlag(true);
 	Asset->PostEditChange();
-	Asset->AddToRoot();
 	Package->FullyLoad();
 
 	// Browse to newly added Asset
@@ -215,89 +282,108 @@ bool IImporter::HandleAssetCreation(UObject* Asset) const {
 	return true;
 }
 
-void IImporter::SavePackage() {
-	const UJsonAsAssetSettings* Settings = GetDefault<UJsonAsAssetSettings>();
-	Package->FullyLoad();
+bool IImporter::SavePackage() {
+	return FAssetUtilities::SavePackage(Package);
+}
 
-	FSavePackageArgs SaveArgs; {
-		SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
-		SaveArgs.SaveFlags = SAVE_NoError;
-	}
+bool IImporter::CommitImport(const FString& File, const FString& Name, const FString& Type) {
+	// Animations are applied to an existing asset, not saved here
+	if (Type == "AnimSequence" || Type == "AnimMontage" || !SavePackage())
+		return false;
 
-	const FString PackageName = Package->GetName();
-	const FString PackageFileName = FPackageName::LongPackageNameToFilename(PackageName, FPackageName::GetAssetPackageExtension());
+	// Only what's on disk can be skipped when the batch is resumed
+	if (FImportJob* Job = FImportJob::Get())
+		Job->Commit(File, Name, Package->GetName());
 
-	if (Settings->bAllowPackageSaving)
-		UPackage::SavePackage(Package, nullptr, *PackageFileName, SaveArgs);
+	return true;
 }
 
 bool IImporter::HandleExports(TArray<TSharedPtr<FJsonValue>> Exports, FString File, const bool bHideNotifications) {
+	// Whatever started this import, prefetches don't outlive it
+	const FPrefetchUtilities::FBatchScope PrefetchScope;
+
 	TArray<FString> Types;
 	for (const TSharedPtr<FJsonValue>& Obj : Exports) Types.Add(Obj->AsObject()->GetStringField("Type"));
 
+	// Materials reference the most assets, start fetching them before the importer reaches them
+	if (Types.Contains("Material") || Types.Contains("MaterialFunction") || Types.Contains("MaterialInstanceConstant"))
+		PrefetchReferences(Exports, FPaths::IsRelative(File) ? FPaths::ConvertRelativePathToFull(File) : File);
+
+	FImportJob* Job = FImportJob::Get();
+
 	for (const TSharedPtr<FJsonValue>& ExportPtr : Exports) {
+		if (Job != nullptr && Job->ShouldCancel())
+			return false;
+
 		TSharedPtr<FJsonObject> DataObject = ExportPtr->AsObject();
 
 		FString Type = DataObject->GetStringField("Type");
 		FString Name = DataObject->GetStringField("Name");
 
-		UClass* Class = FindObject<UClass>(ANY_PACKAGE, *Type);
-		bool bDataAsset = Class->IsChildOf(UDataAsset::StaticClass());
+		const UClass* Class = FClassUtilities::FindClass(*Type);
+		const bool bDataAsset = Class != nullptr && Class->IsChildOf(UDataAsset::StaticClass());
 
 		if (CanImport(Type) || bDataAsset) {
 			// Convert from relative to full
 			// NOTE: Used for references
 			if (FPaths::IsRelative(File)) File = FPaths::ConvertRelativePathToFull(File);
 
-			IImporter* Importer;
+			// Already committed by a previous run of this batch (references too, they're journaled the same way)
+			if (Job != nullptr && Job->IsCommitted(File, Name)) {
+				UE_LOG(LogJson, Log, TEXT("Skipping \"%s\", already imported by this batch"), *Name);
+				continue;
+			}
+
+			TUniquePtr<IImporter> Importer;
 			if (Type == "AnimSequence" || Type == "AnimMontage") 
-				Importer = new UAnimationBaseImporter(Name, File, DataObject, nullptr, nullptr);
+				Importer = MakeUnique<UAnimationBaseImporter>(Name, File, DataObject, nullptr, nullptr);
 			else {
 				UPackage* LocalOutermostPkg;
 				UPackage* LocalPackage = FAssetUtilities::CreateAssetPackage(Name, File, LocalOutermostPkg);
 
-				if (Type == "CurveFloat") Importer = new UCurveFloatImporter(Name, File, DataObject, LocalPackage, LocalOutermostPkg);
-				else if (Type == "CurveTable") Importer = new UCurveTableImporter(Name, File, DataObject, LocalPackage, LocalOutermostPkg);
-				else if (Type == "CurveVector") Importer = new UCurveVectorImporter(Name, File, DataObject, LocalPackage, LocalOutermostPkg);
-				else if (Type == "CurveLinearColor") Importer = new UCurveLinearColorImporter(Name, File, DataObject, LocalPackage, LocalOutermostPkg);
-				else if (Type == "CurveLinearColorAtlas") Importer = new UCurveLinearColorAtlasImporter(Name, File, DataObject, LocalPackage, LocalOutermostPkg);
-
-				else if (Type == "Skeleton") Importer = new USkeletonImporter(Name, File, DataObject, LocalPackage, LocalOutermostPkg, Exports);
-				else if (Type == "SkeletalMeshLODSettings") Importer = new USkeletalMeshLODSettingsImporter(Name, File, DataObject, LocalPackage, LocalOutermostPkg);
-
-				else if (Type == "SoundCue") Importer = new USoundCueImporter(Name, File, DataObject, LocalPackage, LocalOutermostPkg, Exports);
-				else if (Type == "ReverbEffect") Importer = new UReverbEffectImporter(Name, File, DataObject, LocalPackage, LocalOutermostPkg);
-				else if (Type == "SoundAttenuation") Importer = new USoundAttenuationImporter(Name, File, DataObject, LocalPackage, LocalOutermostPkg);
-				else if (Type == "SoundConcurrency") Importer = new USoundConcurrencyImporter(Name, File, DataObject, LocalPackage, LocalOutermostPkg);
-
-				else if (Type == "Material") Importer = new UMaterialImporter(Name, File, DataObject, LocalPackage, LocalOutermostPkg, Exports);
-				else if (Type == "MaterialFunction") Importer = new UMaterialFunctionImporter(Name, File, DataObject, LocalPackage, LocalOutermostPkg, Exports);
-				else if (Type == "MaterialInstanceConstant") Importer = new UMaterialInstanceConstantImporter(Name, File, DataObject, LocalPackage, LocalOutermostPkg, Exports);
-				else if (Type == "MaterialParameterCollection") Importer = new UMaterialParameterCollectionImporter(Name, File, DataObject, LocalPackage, LocalOutermostPkg, Exports);
-				else if (Type == "PhysicalMaterial") Importer = new UPhysicalMaterialImporter(Name, File, DataObject, LocalPackage, LocalOutermostPkg);
-
-				else if (Type == "LandscapeGrassType") Importer = new ULandscapeGrassTypeImporter(Name, File, DataObject, LocalPackage, LocalOutermostPkg);
-				else if (Type == "NiagaraParameterCollection") Importer = new UNiagaraParameterCollectionImporter(Name, File, DataObject, LocalPackage, LocalOutermostPkg);
-
-				else if (Type == "DataTable") Importer = new UDataTableImporter(Name, File, DataObject, LocalPackage, LocalOutermostPkg);
-				else if (Type == "SubsurfaceProfile") Importer = new USubsurfaceProfileImporter(Name, File, DataObject, LocalPackage, LocalOutermostPkg);
-				else if (bDataAsset) Importer = new UDataAssetImporter(Class, Name, File, DataObject, LocalPackage, LocalOutermostPkg, Exports);
+				if (Type == "CurveFloat") Importer = MakeUnique<UCurveFloatImporter>(Name, File, DataObject, LocalPackage, LocalOutermostPkg);
+				else if (Type == "CurveTable") Importer = MakeUnique<UCurveTableImporter>(Name, File, DataObject, LocalPackage, LocalOutermostPkg);
+				else if (Type == "CurveVector") Importer = MakeUnique<UCurveVectorImporter>(Name, File, DataObject, LocalPackage, LocalOutermostPkg);
+				else if (Type == "CurveLinearColor") Importer = MakeUnique<UCurveLinearColorImporter>(Name, File, DataObject, LocalPackage, LocalOutermostPkg);
+				else if (Type == "CurveLinearColorAtlas") Importer = MakeUnique<UCurveLinearColorAtlasImporter>(Name, File, DataObject, LocalPackage, LocalOutermostPkg);
+
+				else if (Type == "Skeleton") Importer = MakeUnique<USkeletonImporter>(Name, File, DataObject, LocalPackage, LocalOutermostPkg, Exports);
+				else if (Type == "SkeletalMeshLODSettings") Importer = MakeUnique<USkeletalMeshLODSettingsImporter>(Name, File, DataObject, LocalPackage, LocalOutermostPkg);
+
+				else if (Type == "SoundCue") Importer = MakeUnique<USoundCueImporter>(Name, File, DataObject, LocalPackage, LocalOutermostPkg, Exports);
+				else if (Type == "ReverbEffect") Importer = MakeUnique<UReverbEffectImporter>(Name, File, DataObject, LocalPackage, LocalOutermostPkg);
+				else if (Type == "SoundAttenuation") Importer = MakeUnique<USoundAttenuationImporter>(Name, File, DataObject, LocalPackage, LocalOutermostPkg);
+				else if (Type == "SoundConcurrency") Importer = MakeUnique<USoundConcurrencyImporter>(Name, File, DataObject, LocalPackage, LocalOutermostPkg);
+
+				else if (Type == "Material") Importer = MakeUnique<UMaterialImporter>(Name, File, DataObject, LocalPackage, LocalOutermostPkg, Exports);
+				else if (Type == "MaterialFunction") Importer = MakeUnique<UMaterialFunctionImporter>(Name, File, DataObject, LocalPackage, LocalOutermostPkg, Exports);
+				else if (Type == "MaterialInstanceConstant") Importer = MakeUnique<UMaterialInstanceConstantImporter>(Name, File, DataObject, LocalPackage, LocalOutermostPkg, Exports);
+				else if (Type == "MaterialParameterCollection") Importer = MakeUnique<UMaterialParameterCollectionImporter>(Name, File, DataObject, LocalPackage, LocalOutermostPkg, Exports);
+				else if (Type == "PhysicalMaterial") Importer = MakeUnique<UPhysicalMaterialImporter>(Name, File, DataObject, LocalPackage, LocalOutermostPkg);
+
+				else if (Type == "LandscapeGrassType") Importer = MakeUnique<ULandscapeGrassTypeImporter>(Name, File, DataObject, LocalPackage, LocalOutermostPkg);
+				else if (Type == "NiagaraParameterCollection") Importer = MakeUnique<UNiagaraParameterCollectionImporter>(Name, File, DataObject, LocalPackage, LocalOutermostPkg);
+
+				else if (Type == "DataTable") Importer = MakeUnique<UDataTableImporter>(Name, File, DataObject, LocalPackage, LocalOutermostPkg);
+				else if (Type == "SubsurfaceProfile") Importer = MakeUnique<USubsurfaceProfileImporter>(Name, File, DataObject, LocalPackage, LocalOutermostPkg);
+				else if (Type == "Texture2D" || Type == "TextureCube" || Type == "VolumeTexture" || Type == "Texture2DArray") Importer = MakeUnique<UTextureImporter>(Name, File, DataObject, LocalPackage, LocalOutermostPkg);
+				else if (bDataAsset) Importer = MakeUnique<UDataAssetImporter>(Class, Name, File, DataObject, LocalPackage, LocalOutermostPkg, Exports);
 				else Importer = nullptr;
 			}
 
 			FMessageLog MessageLogger = FMessageLog(FName("JsonAsAsset"));
 
 			if (bHideNotifications) {
-				Importer->ImportData();
+				if (Importer != nullptr && Importer->ImportData())
+					Importer->CommitImport(File, Name, Type);
 
 				return true;
 			}
 
 			if (Importer != nullptr && Importer->ImportData()) {
 				UE_LOG(LogJson, Log, TEXT("Successfully imported \"%s\" as \"%s\""), *Name, *Type);
-				
-				if (!(Type == "AnimSequence" || Type == "AnimMontage"))
-					Importer->SavePackage();
+
+				Importer->CommitImport(File, Name, Type);
 
 				// Notification for asset
 				AppendNotification(
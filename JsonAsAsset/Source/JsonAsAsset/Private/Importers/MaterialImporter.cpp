@@ -11,6 +11,7 @@
 #include "Framework/Notifications/NotificationManager.h"
 #include "Dom/JsonObject.h"
 #include "Factories/MaterialFactoryNew.h"
+#include "Utilities/EnumUtilities.h"
 #include "Utilities/MathUtilities.h"
 #include "MaterialEditor/Private/MaterialEditor.h"
 #include "MaterialGraph/MaterialGraph.h"
@@ -83,7 +84,7 @@ bool UMaterialImporter::ImportData() {
 		GetObjectSerializer()->DeserializeObjectProperties(SerializerProperties, Material);
 		
 		if (FString ShadingModel; Properties->TryGetStringField("ShadingModel", ShadingModel) && ShadingModel != "EMaterialShadingModel::MSM_FromMaterialExpression")
-			Material->SetShadingModel(static_cast<EMaterialShadingModel>(StaticEnum<EMaterialShadingModel>()->GetValueByNameString(ShadingModel)));
+			Material->SetShadingModel(FEnumUtilities::GetValue<EMaterialShadingModel>(ShadingModel));
 		if (const TSharedPtr<FJsonObject>* ShadingModelsPtr; Properties->TryGetObjectField("ShadingModels", ShadingModelsPtr))
 			if (int ShadingModelField; ShadingModelsPtr->Get()->TryGetNumberField("ShadingModelField", ShadingModelField))
 				Material->GetShadingModels().SetShadingModelField(ShadingModelField);
@@ -4,6 +4,7 @@
 
 #include "Dom/JsonObject.h"
 #include "Materials/MaterialInstanceConstant.h"
+#include "Utilities/EnumUtilities.h"
 #include "Utilities/MathUtilities.h"
 #include "RHIDefinitions.h"
 
@@ -173,7 +174,7 @@ bool UMaterialInstanceConstantImporter::ImportData() {
 			// Create Material Parameter Info
 			FMaterialParameterInfo MaterialParameterParameterInfo = FMaterialParameterInfo(
 				FName(Local_MaterialParameterInfo->GetStringField("Name")),
-				static_cast<EMaterialParameterAssociation>(StaticEnum<EMaterialParameterAssociation>()->GetValueByNameString(Local_MaterialParameterInfo->GetStringField("Association"))),
+				FEnumUtilities::GetValue<EMaterialParameterAssociation>(Local_MaterialParameterInfo->GetStringField("Association")),
 				Local_MaterialParameterInfo->GetIntegerField("Index")
 			);
 
@@ -203,7 +204,7 @@ bool UMaterialInstanceConstantImporter::ImportData() {
 			// Create Material Parameter Info
 			FMaterialParameterInfo MaterialParameterParameterInfo = FMaterialParameterInfo(
 				FName(Local_MaterialParameterInfo->GetStringField("Name")),
-				static_cast<EMaterialParameterAssociation>(StaticEnum<EMaterialParameterAssociation>()->GetValueByNameString(Local_MaterialParameterInfo->GetStringField("Association"))),
+				FEnumUtilities::GetValue<EMaterialParameterAssociation>(Local_MaterialParameterInfo->GetStringField("Association")),
 				Local_MaterialParameterInfo->GetIntegerField("Index")
 			);
 
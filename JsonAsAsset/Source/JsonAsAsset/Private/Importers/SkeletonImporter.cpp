@@ -7,6 +7,7 @@
 #include "Engine/SkeletalMeshSocket.h"
 #include "Factories/TextureFactory.h"
 #include "Utilities/AssetUtilities.h"
+#include "Utilities/EnumUtilities.h"
 #include "Utilities/MathUtilities.h"
 
 bool USkeletonAssetDerived::AddVirtualBone(const FName SourceBoneName, const FName TargetBoneName, const FName VirtualBoneRootName) {
@@ -51,7 +52,7 @@ bool USkeletonImporter::ImportData() {
 				for (int i = 0; i < Properties->GetArrayField("BoneTree").Num(); i++) {
 					const TSharedPtr<FJsonObject> BoneNode = Properties->GetArrayField("BoneTree")[i]->AsObject();
 					FString TranslationRetargetingMode = BoneNode->GetStringField("TranslationRetargetingMode");
-					Skeleton->SetBoneTranslationRetargetingMode(i, static_cast<EBoneTranslationRetargetingMode::Type>(StaticEnum<EBoneTranslationRetargetingMode::Type>()->GetValueByNameString(TranslationRetargetingMode)), false);
+					Skeleton->SetBoneTranslationRetargetingMode(i, FEnumUtilities::GetValue<EBoneTranslationRetargetingMode::Type>(TranslationRetargetingMode), false);
 				}
 			}
 
@@ -2,6 +2,7 @@
 
 #include "Importers/SoundCueImporter.h"
 #include "Sound/SoundCue.h"
+#include "Utilities/ClassUtilities.h"
 #include <Runtime/Engine/Classes/Sound/SoundNodeWavePlayer.h>
 
 bool USoundCueImporter::ImportData() {
@@ -17,7 +18,6 @@ bool USoundCueImporter::ImportData() {
 		// Sort, and find each node
 		for (const TSharedPtr<FJsonValue> Export : AllJsonObjects) {
 			TSharedPtr<FJsonObject> Object = Export->AsObject();
-			UClass* Class = FindObject<UClass>(ANY_PACKAGE, *Object->GetStringField("Type"));
 
 			if (Object->GetStringField("Type").StartsWith("SoundNode"))
 				NodeTree.Add(MakeShareable(Object.Get()));
@@ -32,7 +32,12 @@ bool USoundCueImporter::ImportData() {
 			TSharedPtr<FJsonObject> NodeProperties = NodeReference->GetObjectField("Properties");
 
 			// Construct sound node
-			const UClass* Class = FindObject<UClass>(ANY_PACKAGE, *Type);
+			const UClass* Class = FClassUtilities::FindClass(*Type);
+			if (Class == nullptr) {
+				UE_LOG(LogJson, Warning, TEXT("Skipping sound node \"%s\", unknown type %s"), *Name, *Type);
+				continue;
+			}
+
 			USoundNode* SoundNode = NewObject<USoundNode>(SoundCue, Class, FName(*Name), RF_Transactional);
 
 			SoundCue->AllNodes.Add(SoundNode);
@@ -1,46 +1,222 @@
 ﻿#include "Importers/TextureImporter.h"
 
 #include "detex.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "RenderUtils.h"
+#include "Async/MappedFileHandle.h"
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformFileManager.h"
 #include "Engine/TextureRenderTarget2D.h"
 #include "Engine/TextureCube.h"
+#include "Engine/Texture2DArray.h"
+#include "Engine/VolumeTexture.h"
 #include "Factories/TextureRenderTargetFactoryNew.h"
 #include "nvimage/DirectDrawSurface.h"
 #include "nvimage/Image.h"
+#include "Utilities/EnumUtilities.h"
 #include "Utilities/MathUtilities.h"
+#include "Utilities/TextureDecode/TextureCache.h"
+#include "Utilities/TextureDecode/TextureDDS.h"
+#include "Utilities/TextureDecode/TextureDetex.h"
 #include "Utilities/TextureDecode/TextureNVTT.h"
+#include "Utilities/TextureDecode/TextureSwizzle.h"
 
-bool UTextureImporter::ImportTexture2D(UTexture*& OutTexture2D, TArray<uint8>& Data, const TSharedPtr<FJsonObject>& Properties) const {
-	const TSharedPtr<FJsonObject> SubObjectProperties = Properties->GetObjectField("Properties");
+#include <atomic>
 
-	// NEW: .bin support
-	UTexture2D* Texture2D = NewObject<UTexture2D>(OutermostPkg, UTexture2D::StaticClass(), *FileName, RF_Standalone | RF_Public);
-	Texture2D->SetPlatformData(new FTexturePlatformData());
+// Nothing made it into the texture, it isn't left behind (and saved) in its package
+static void DiscardTexture(UTexture* Texture) {
+	Texture->ClearFlags(RF_Standalone | RF_Public);
+	Texture->MarkAsGarbage();
+}
 
-	ImportTexture2D_Data(Texture2D, SubObjectProperties);
-	FTexturePlatformData* PlatformData = Texture2D->GetPlatformData();
+bool UTextureImporter::ImportData() {
+	const FString ImageFile = FindLocalImageFile();
+	if (ImageFile.IsEmpty()) {
+		UE_LOG(LogJson, Error, TEXT("No exported image (.dds or .png) found next to \"%s\""), *FilePath);
+		return false;
+	}
+
+	const FString Type = JsonObject->GetStringField("Type");
+
+	FTextureDecodeJob Job;
+	UTexture* Texture = nullptr;
+
+	if (Type == "Texture2D")
+		Texture = CreateTexture2D(JsonObject, Job);
+	if (Type == "TextureCube")
+		Texture = CreateTextureCube(JsonObject, Job);
+	if (Type == "VolumeTexture")
+		Texture = CreateVolumeTexture(JsonObject, Job);
+	if (Type == "Texture2DArray")
+		Texture = CreateTexture2DArray(JsonObject, Job);
+
+	if (Texture == nullptr)
+		return false;
+
+	// Mapped rather than read, the decoders read the surfaces straight from the file
+	const TUniquePtr<IMappedFileHandle> MappedFile(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*ImageFile));
+	const TUniquePtr<IMappedFileRegion> MappedRegion(MappedFile.IsValid() ? MappedFile->MapRegion() : nullptr);
+
+	if (!MappedRegion.IsValid()) {
+		UE_LOG(LogJson, Error, TEXT("Failed to open \"%s\""), *ImageFile);
+		DiscardTexture(Texture);
+		return false;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	const uint8* Data = MappedRegion->GetMappedPtr();
+	const int64 Size = MappedRegion->GetMappedSize();
+
+	const bool bImported = FPaths::GetExtension(ImageFile) == "dds" ? ImportDDSFile(Texture, Job, Data, Size) : ImportPNGFile(Texture, Job, Data, Size);
+	if (!bImported) {
+		UE_LOG(LogJson, Error, TEXT("Failed to import \"%s\", unsupported image or pixel format"), *ImageFile);
+		DiscardTexture(Texture);
+		return false;
+	}
+
+	UE_LOG(LogJson, Log, TEXT("Imported %s from %s in %.2f ms (%dx%d, %d slices)"), *FileName, *FPaths::GetCleanFilename(ImageFile), (FPlatformTime::Seconds() - StartTime) * 1000.0, Job.SizeX, Job.SizeY, Job.NumSlices);
+
+	return HandleAssetCreation(Texture);
+}
+
+FString UTextureImporter::FindLocalImageFile() const {
+	// FModel saves images under the asset's name, in the folder of its JSON
+	const FString BasePath = FPaths::GetPath(FilePath) / FileName;
+
+	for (const TCHAR* Extension : { TEXT(".dds"), TEXT(".png") }) {
+		if (FPaths::FileExists(BasePath + Extension))
+			return BasePath + Extension;
+	}
+
+	return FString();
+}
+
+bool UTextureImporter::ImportDDSFile(UTexture* Texture, FTextureDecodeJob& Job, const uint8* Data, const int64 Size) {
+	FDDSLayout Layout;
+	if (!ParseDDS(Data, Size, Layout))
+		return false;
+
+	// A flat image can't fill a cube (or the other way around), the source would be sized for the wrong layout
+	const bool bMatchesType = Texture->IsA<UTextureCube>() ? Layout.bCubemap && Layout.NumSlices == 6
+		: Texture->IsA<UVolumeTexture>() ? Layout.bVolume
+		: Texture->IsA<UTexture2DArray>() ? !Layout.bVolume && !Layout.bCubemap
+		: !Layout.bVolume && !Layout.bCubemap && Layout.NumSlices == 1;
+
+	if (!bMatchesType) {
+		UE_LOG(LogJson, Error, TEXT("The DDS file (%d slices%s%s) doesn't match the layout of a %s"), Layout.NumSlices, Layout.bCubemap ? TEXT(", cubemap") : TEXT(""), Layout.bVolume ? TEXT(", volume") : TEXT(""), *Texture->GetClass()->GetName());
+		return false;
+	}
+
+	// The file is what gets decoded, whatever the export says
+	Job.SizeX = Layout.SizeX;
+	Job.SizeY = Layout.SizeY;
+	Job.NumSlices = Layout.bVolume ? Layout.SizeZ : Layout.NumSlices;
+	Job.PixelFormat = Layout.PixelFormat;
+	Job.Format = GetSourceFormat(Layout.PixelFormat);
+
+	// Lower mips are only of use when the texture doesn't generate its own, volumes always do
+	int32 NumMips = Texture->MipGenSettings == TMGS_LeaveExistingMips && !Layout.bVolume ? Layout.NumMips : 1;
+	if (GetDDSSurfaceOffset(Layout, Job.NumSlices - 1, NumMips - 1) + GetDDSSurfaceSize(Layout, NumMips - 1) > Size)
+		NumMips = 1;
+
+	Texture->Source.Init(Job.SizeX, Job.SizeY, Job.NumSlices, NumMips, Job.Format);
+
+	struct FSurface {
+		const uint8* Data;
+		uint8* OutData;
+		int64 OutSize;
+		int32 Mip;
+	};
+
+	TArray<FSurface> Surfaces;
+	bool bLocked = true;
+	int32 NumLockedMips = 0;
+
+	for (int32 Mip = 0; bLocked && Mip < NumMips; Mip++) {
+		uint8* MipData = Texture->Source.LockMip(Mip);
+		if (MipData != nullptr)
+			NumLockedMips++;
+
+		const int64 SliceSize = static_cast<int64>(FMath::Max(1, Job.SizeX >> Mip)) * FMath::Max(1, Job.SizeY >> Mip) * FTextureSource::GetBytesPerPixel(Job.Format);
+		bLocked &= MipData != nullptr && SliceSize * Job.NumSlices == Texture->Source.CalcMipSize(Mip);
+
+		for (int32 Slice = 0; bLocked && Slice < Job.NumSlices; Slice++)
+			Surfaces.Add({ Data + GetDDSSurfaceOffset(Layout, Slice, Mip), MipData + Slice * SliceSize, SliceSize, Mip });
+	}
+
+	// Every surface is its own task, and still split in stripes by the decoders
+	std::atomic<bool> bSucceeded = bLocked;
+
+	if (bLocked) {
+		ParallelFor(Surfaces.Num(), [&](const int32 Index) {
+			const FSurface& Surface = Surfaces[Index];
+
+			const int32 MipSizeX = FMath::Max(1, Job.SizeX >> Surface.Mip);
+			const int32 MipSizeY = FMath::Max(1, Job.SizeY >> Surface.Mip);
+
+			if (!GetDecompressedTextureData(Surface.Data, Surface.OutData, MipSizeX, MipSizeY, Surface.OutSize, Job.PixelFormat))
+				bSucceeded = false;
+		});
+	}
+
+	Job.bDecoded = bSucceeded;
+
+	// Same as FinalizeTexture, nothing half decoded stays in the source
+	if (!Job.bDecoded) {
+		for (const FSurface& Surface : Surfaces)
+			FMemory::Memzero(Surface.OutData, Surface.OutSize);
+	}
+
+	// Mips lock in order, the first one that didn't is where it stopped
+	for (int32 Mip = 0; Mip < NumLockedMips; Mip++)
+		Texture->Source.UnlockMip(Mip);
+
+	Texture->UpdateResource();
+
+	return Job.bDecoded;
+}
+
+bool UTextureImporter::ImportPNGFile(UTexture* Texture, FTextureDecodeJob& Job, const uint8* Data, const int64 Size) {
+	// Flat images are only saved for 2D textures
+	if (!Texture->IsA<UTexture2D>())
+		return false;
 
-	const int SizeX = Properties->GetNumberField("SizeX");
-	const int SizeY = Properties->GetNumberField("SizeY");
+	IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>("ImageWrapper");
+	const TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::PNG);
 
-	if (FString PixelFormat; Properties->TryGetStringField("PixelFormat", PixelFormat)) PlatformData->PixelFormat = static_cast<EPixelFormat>(Texture2D->GetPixelFormatEnum()->GetValueByNameString(PixelFormat));
+	if (!ImageWrapper.IsValid() || !ImageWrapper->SetCompressed(Data, Size))
+		return false;
 
-	int Size = SizeX * SizeY * (PlatformData->PixelFormat == PF_BC6H ? 16 : 4);
-	if (PlatformData->PixelFormat == PF_FloatRGBA || PlatformData->PixelFormat == PF_G16) Size = Data.Num();
-	uint8* DecompressedData = static_cast<uint8*>(FMemory::Malloc(Size));
+	const bool bHighBitDepth = ImageWrapper->GetBitDepth() > 8;
 
-	GetDecompressedTextureData(Data.GetData(), DecompressedData, SizeX, SizeY, Size, PlatformData->PixelFormat);
+	Job.SizeX = ImageWrapper->GetWidth();
+	Job.SizeY = ImageWrapper->GetHeight();
+	Job.NumSlices = 1;
+	Job.Format = bHighBitDepth ? TSF_RGBA16 : TSF_BGRA8;
 
-	ETextureSourceFormat Format = TSF_BGRA8;
-	if (Texture2D->CompressionSettings == TC_HDR) Format = TSF_RGBA16F;
-	if (PlatformData->PixelFormat == PF_G16) Format = TSF_G16;
-	Texture2D->Source.Init(SizeX, SizeY, 1, 1, Format);
-	uint8_t* Dest = Texture2D->Source.LockMip(0);
-	FMemory::Memcpy(Dest, DecompressedData, Size);
-	Texture2D->Source.UnlockMip(0);
+	TArray64<uint8> RawData;
+	if (!ImageWrapper->GetRaw(bHighBitDepth ? ERGBFormat::RGBA : ERGBFormat::BGRA, bHighBitDepth ? 16 : 8, RawData))
+		return false;
 
-	Texture2D->UpdateResource();
+	BeginDecode(Texture, Job, RawData.Num());
+
+	Job.bDecoded = Job.MipData != nullptr && Job.MipSize == RawData.Num();
+	if (Job.bDecoded)
+		FMemory::Memcpy(Job.MipData, RawData.GetData(), RawData.Num());
+
+	return FinalizeTexture(Texture, Job);
+}
+
+bool UTextureImporter::ImportTexture2D(UTexture*& OutTexture2D, TArray<uint8>& Data, const TSharedPtr<FJsonObject>& Properties) const {
+	FTextureDecodeJob Job;
+	UTexture2D* Texture2D = CreateTexture2D(Properties, Job);
 
-	if (Texture2D) {
+	BeginDecode(Texture2D, Job, Data.Num());
+	DecodeTexture(Job, Data);
+
+	if (FinalizeTexture(Texture2D, Job)) {
 		OutTexture2D = Texture2D;
 		return true;
 	}
@@ -49,6 +225,44 @@ bool UTextureImporter::ImportTexture2D(UTexture*& OutTexture2D, TArray<uint8>& D
 }
 
 bool UTextureImporter::ImportTextureCube(UTexture*& OutTextureCube, TArray<uint8>& Data, const TSharedPtr<FJsonObject>& Properties) const {
+	FTextureDecodeJob Job;
+	UTextureCube* TextureCube = CreateTextureCube(Properties, Job);
+
+	BeginDecode(TextureCube, Job, Data.Num());
+	DecodeTexture(Job, Data);
+
+	if (FinalizeTexture(TextureCube, Job)) {
+		TextureCube->PostEditChange();
+
+		OutTextureCube = TextureCube;
+		return true;
+	}
+
+	return false;
+}
+
+UTexture2D* UTextureImporter::CreateTexture2D(const TSharedPtr<FJsonObject>& Properties, FTextureDecodeJob& OutJob) const {
+	const TSharedPtr<FJsonObject> SubObjectProperties = Properties->GetObjectField("Properties");
+
+	// NEW: .bin support
+	UTexture2D* Texture2D = NewObject<UTexture2D>(OutermostPkg, UTexture2D::StaticClass(), *FileName, RF_Standalone | RF_Public);
+	Texture2D->SetPlatformData(new FTexturePlatformData());
+
+	ImportTexture2D_Data(Texture2D, SubObjectProperties);
+	FTexturePlatformData* PlatformData = Texture2D->GetPlatformData();
+
+	OutJob.SizeX = Properties->GetNumberField("SizeX");
+	OutJob.SizeY = Properties->GetNumberField("SizeY");
+
+	if (FString PixelFormat; Properties->TryGetStringField("PixelFormat", PixelFormat)) PlatformData->PixelFormat = static_cast<EPixelFormat>(FEnumUtilities::GetValue(Texture2D->GetPixelFormatEnum(), PixelFormat));
+	OutJob.PixelFormat = PlatformData->PixelFormat;
+
+	OutJob.Format = GetSourceFormat(PlatformData->PixelFormat);
+
+	return Texture2D;
+}
+
+UTextureCube* UTextureImporter::CreateTextureCube(const TSharedPtr<FJsonObject>& Properties, FTextureDecodeJob& OutJob) const {
 	UTextureCube* TextureCube = NewObject<UTextureCube>(Package, UTextureCube::StaticClass(), *FileName, RF_Public | RF_Standalone);
 
 	TextureCube->SetPlatformData(new FTexturePlatformData());
@@ -56,33 +270,198 @@ bool UTextureImporter::ImportTextureCube(UTexture*& OutTextureCube, TArray<uint8
 	ImportTexture_Data(TextureCube, Properties);
 	FTexturePlatformData* PlatformData = TextureCube->GetPlatformData();
 
-	const int SizeX = Properties->GetNumberField("SizeX");
-	const int SizeY = Properties->GetNumberField("SizeY") / 6;
+	OutJob.SizeX = Properties->GetNumberField("SizeX");
+	OutJob.SizeY = Properties->GetNumberField("SizeY") / 6;
+	OutJob.NumSlices = 6;
 
-	if (FString PixelFormat; Properties->TryGetStringField("PixelFormat", PixelFormat)) PlatformData->PixelFormat = static_cast<EPixelFormat>(TextureCube->GetPixelFormatEnum()->GetValueByNameString(PixelFormat));
+	if (FString PixelFormat; Properties->TryGetStringField("PixelFormat", PixelFormat)) PlatformData->PixelFormat = static_cast<EPixelFormat>(FEnumUtilities::GetValue(TextureCube->GetPixelFormatEnum(), PixelFormat));
+	OutJob.PixelFormat = PlatformData->PixelFormat;
 
-	int Size = SizeX * SizeY * (PlatformData->PixelFormat == PF_BC6H ? 16 : 4);
-	if (PlatformData->PixelFormat == PF_FloatRGBA) Size = Data.Num();
-	uint8* DecompressedData = static_cast<uint8*>(FMemory::Malloc(Size));
+	OutJob.Format = GetSourceFormat(PlatformData->PixelFormat);
 
-	ETextureSourceFormat Format = TSF_BGRA8;
-	if (TextureCube->CompressionSettings == TC_HDR) Format = TSF_RGBA16F;
-	TextureCube->Source.Init(SizeX, SizeY, 1, 1, Format);
-	uint8_t* Dest = TextureCube->Source.LockMip(0);
-	FMemory::Memcpy(Dest, DecompressedData, Size);
-	TextureCube->Source.UnlockMip(0);
+	return TextureCube;
+}
 
-	TextureCube->PostEditChange();
+UVolumeTexture* UTextureImporter::CreateVolumeTexture(const TSharedPtr<FJsonObject>& Properties, FTextureDecodeJob& OutJob) const {
+	UVolumeTexture* VolumeTexture = NewObject<UVolumeTexture>(OutermostPkg, UVolumeTexture::StaticClass(), *FileName, RF_Public | RF_Standalone);
 
-	if (TextureCube) {
-		OutTextureCube = TextureCube;
+	VolumeTexture->SetPlatformData(new FTexturePlatformData());
+
+	ImportTexture_Data(VolumeTexture, Properties->GetObjectField("Properties"));
+	FTexturePlatformData* PlatformData = VolumeTexture->GetPlatformData();
+
+	OutJob.SizeX = Properties->GetNumberField("SizeX");
+	OutJob.SizeY = Properties->GetNumberField("SizeY");
+
+	// Depth isn't always exported, counted from the data then
+	OutJob.NumSlices = 0;
+	if (int SizeZ; Properties->TryGetNumberField("SizeZ", SizeZ)) OutJob.NumSlices = SizeZ;
+
+	if (FString PixelFormat; Properties->TryGetStringField("PixelFormat", PixelFormat)) PlatformData->PixelFormat = static_cast<EPixelFormat>(FEnumUtilities::GetValue(VolumeTexture->GetPixelFormatEnum(), PixelFormat));
+	OutJob.PixelFormat = PlatformData->PixelFormat;
+
+	OutJob.Format = GetSourceFormat(PlatformData->PixelFormat);
+
+	return VolumeTexture;
+}
+
+UTexture2DArray* UTextureImporter::CreateTexture2DArray(const TSharedPtr<FJsonObject>& Properties, FTextureDecodeJob& OutJob) const {
+	UTexture2DArray* Texture2DArray = NewObject<UTexture2DArray>(OutermostPkg, UTexture2DArray::StaticClass(), *FileName, RF_Public | RF_Standalone);
+
+	Texture2DArray->SetPlatformData(new FTexturePlatformData());
+
+	ImportTexture_Data(Texture2DArray, Properties->GetObjectField("Properties"));
+	FTexturePlatformData* PlatformData = Texture2DArray->GetPlatformData();
+
+	OutJob.SizeX = Properties->GetNumberField("SizeX");
+	OutJob.SizeY = Properties->GetNumberField("SizeY");
+
+	// Layer count isn't always exported, counted from the data then
+	OutJob.NumSlices = 0;
+	if (int NumSlices; Properties->TryGetNumberField("NumSlices", NumSlices)) OutJob.NumSlices = NumSlices;
+
+	if (FString PixelFormat; Properties->TryGetStringField("PixelFormat", PixelFormat)) PlatformData->PixelFormat = static_cast<EPixelFormat>(FEnumUtilities::GetValue(Texture2DArray->GetPixelFormatEnum(), PixelFormat));
+	OutJob.PixelFormat = PlatformData->PixelFormat;
+
+	OutJob.Format = GetSourceFormat(PlatformData->PixelFormat);
+
+	return Texture2DArray;
+}
+
+void UTextureImporter::BeginDecode(UTexture* Texture, FTextureDecodeJob& Job, const int64 DataSize) {
+	if (Texture == nullptr)
+		return;
+
+	if (Job.NumSlices <= 0) {
+		const int64 SliceSize = GetPlatformSliceSize(Job.SizeX, Job.SizeY, Job.PixelFormat);
+		Job.NumSlices = SliceSize > 0 ? static_cast<int32>(FMath::Max<int64>(1, DataSize / SliceSize)) : 1;
+	}
+
+	// A texture that was already built (from its proxy) may still be compiling from the old source, finished before it's freed
+	Texture->PreEditChange(nullptr);
+
+	Texture->Source.Init(Job.SizeX, Job.SizeY, Job.NumSlices, 1, Job.Format);
+
+	Job.MipSize = Texture->Source.CalcMipSize(0);
+	Job.MipData = Texture->Source.LockMip(0);
+}
+
+bool UTextureImporter::DecodeTexture(FTextureDecodeJob& Job, const TArray<uint8>& Data) {
+	Job.bDecoded = false;
+
+	if (Job.MipData == nullptr)
+		return false;
+
+	// The source format is picked from the pixel format, decoders always fill the mip exactly
+	const int64 SliceSize = static_cast<int64>(Job.SizeX) * Job.SizeY * FTextureSource::GetBytesPerPixel(Job.Format);
+	if (SliceSize * Job.NumSlices != Job.MipSize) {
+		UE_LOG(LogJson, Error, TEXT("Decoded size of %s doesn't match its source (%lld vs %lld bytes)"), GetPixelFormatString(Job.PixelFormat), SliceSize * Job.NumSlices, Job.MipSize);
+		return false;
+	}
+
+	// The decoders read a whole slice, never hand them less than that
+	const int64 PlatformSliceSize = GetPlatformSliceSize(Job.SizeX, Job.SizeY, Job.PixelFormat);
+	if (PlatformSliceSize <= 0) {
+		UE_LOG(LogJson, Error, TEXT("Unknown block size for %s, can't decode it"), GetPixelFormatString(Job.PixelFormat));
+		return false;
+	}
+
+	// Never read past the data, slices it doesn't have are zeroed (there is nothing to import without the first one)
+	int32 NumSlices = Job.NumSlices;
+	if (Data.Num() < PlatformSliceSize * NumSlices) {
+		NumSlices = static_cast<int32>(Data.Num() / PlatformSliceSize);
+		UE_LOG(LogJson, Warning, TEXT("Texture data only has %d of %d slices (%s), the rest are left black"), NumSlices, Job.NumSlices, GetPixelFormatString(Job.PixelFormat));
+
+		FMemory::Memzero(Job.MipData + NumSlices * SliceSize, (Job.NumSlices - NumSlices) * SliceSize);
+	}
+
+	if (NumSlices == 0) {
+		UE_LOG(LogJson, Error, TEXT("Texture data is too short for a single %dx%d slice (%d of %lld bytes, %s)"), Job.SizeX, Job.SizeY, Data.Num(), PlatformSliceSize, GetPixelFormatString(Job.PixelFormat));
+		return false;
+	}
+
+	if (NumSlices == 1) {
+		Job.bDecoded = GetDecompressedTextureData(Data.GetData(), Job.MipData, Job.SizeX, Job.SizeY, SliceSize, Job.PixelFormat);
+		return Job.bDecoded;
+	}
+
+	// Slices are independent, each one still goes through the stripe-parallel decoders
+	std::atomic<bool> bSucceeded = true;
+
+	ParallelFor(NumSlices, [&](const int32 Slice) {
+		if (!GetDecompressedTextureData(Data.GetData() + Slice * PlatformSliceSize, Job.MipData + Slice * SliceSize, Job.SizeX, Job.SizeY, SliceSize, Job.PixelFormat))
+			bSucceeded = false;
+	});
+
+	Job.bDecoded = bSucceeded;
+	return Job.bDecoded;
+}
+
+ETextureSourceFormat UTextureImporter::GetSourceFormat(const EPixelFormat Format) {
+	// Uncompressed formats are expanded to the closest source format
+	if (ETextureSourceFormat SourceFormat; GetUncompressedSourceFormat(Format, SourceFormat))
+		return SourceFormat;
+
+	// Follows what we decode to, not the compression settings (HDR textures are fine with an 8-bit source)
+	return IsHalfFloatDecoded(Format) ? TSF_RGBA16F : TSF_BGRA8;
+}
+
+int64 UTextureImporter::GetPlatformSliceSize(const int SizeX, const int SizeY, const EPixelFormat Format) {
+	const FPixelFormatInfo& Info = GPixelFormats[Format];
+	if (Info.BlockBytes == 0 || Info.BlockSizeX == 0 || Info.BlockSizeY == 0)
+		return 0;
+
+	return static_cast<int64>(FMath::DivideAndRoundUp(SizeX, Info.BlockSizeX)) * FMath::DivideAndRoundUp(SizeY, Info.BlockSizeY) * Info.BlockBytes;
+}
+
+bool UTextureImporter::FinalizeTexture(UTexture* Texture, const FTextureDecodeJob& Job) {
+	if (Texture == nullptr)
+		return false;
+
+	if (Job.MipData != nullptr) {
+		// Never leave uninitialized memory in the source, even on a texture that won't be saved
+		if (!Job.bDecoded)
+			FMemory::Memzero(Job.MipData, Job.MipSize);
+
+		Texture->Source.UnlockMip(0);
+	}
+
+	Texture->UpdateResource();
+
+	return Job.bDecoded;
+}
+
+bool UTextureImporter::ImportVolumeTexture(UTexture*& OutVolumeTexture, const TArray<uint8>& Data, const TSharedPtr<FJsonObject>& Properties) const {
+	FTextureDecodeJob Job;
+	UVolumeTexture* VolumeTexture = CreateVolumeTexture(Properties, Job);
+
+	BeginDecode(VolumeTexture, Job, Data.Num());
+	DecodeTexture(Job, Data);
+
+	if (FinalizeTexture(VolumeTexture, Job)) {
+		VolumeTexture->PostEditChange();
+
+		OutVolumeTexture = VolumeTexture;
 		return true;
 	}
 
 	return false;
 }
 
-bool UTextureImporter::ImportVolumeTexture(UTexture*& OutTexture2D, const TArray<uint8>& Data, const TSharedPtr<FJsonObject>& Properties) const {
+bool UTextureImporter::ImportTexture2DArray(UTexture*& OutTexture2DArray, const TArray<uint8>& Data, const TSharedPtr<FJsonObject>& Properties) const {
+	FTextureDecodeJob Job;
+	UTexture2DArray* Texture2DArray = CreateTexture2DArray(Properties, Job);
+
+	BeginDecode(Texture2DArray, Job, Data.Num());
+	DecodeTexture(Job, Data);
+
+	if (FinalizeTexture(Texture2DArray, Job)) {
+		Texture2DArray->PostEditChange();
+
+		OutTexture2DArray = Texture2DArray;
+		return true;
+	}
+
 	return false;
 }
 
@@ -90,6 +469,7 @@ bool UTextureImporter::ImportRenderTarget2D(UTexture*& OutRenderTarget2D, const
 	UTextureRenderTargetFactoryNew* TextureFactory = NewObject<UTextureRenderTargetFactoryNew>();
 	TextureFactory->AddToRoot();
 	UTextureRenderTarget2D* RenderTarget2D = Cast<UTextureRenderTarget2D>(TextureFactory->FactoryCreateNew(UTextureRenderTarget2D::StaticClass(), OutermostPkg, *FileName, RF_Standalone | RF_Public, nullptr, GWarn));
+	TextureFactory->RemoveFromRoot();
 
 	ImportTexture_Data(RenderTarget2D, Properties);
 
@@ -99,17 +479,17 @@ bool UTextureImporter::ImportRenderTarget2D(UTexture*& OutRenderTarget2D, const
 	if (Properties->TryGetNumberField("SizeY", SizeY)) RenderTarget2D->SizeY = SizeY;
 
 	FString AddressX;
-	if (Properties->TryGetStringField("AddressX", AddressX)) RenderTarget2D->AddressX = static_cast<TextureAddress>(StaticEnum<TextureAddress>()->GetValueByNameString(AddressX));
+	if (Properties->TryGetStringField("AddressX", AddressX)) RenderTarget2D->AddressX = FEnumUtilities::GetValue<TextureAddress>(AddressX);
 	FString AddressY;
-	if (Properties->TryGetStringField("AddressY", AddressY)) RenderTarget2D->AddressY = static_cast<TextureAddress>(StaticEnum<TextureAddress>()->GetValueByNameString(AddressY));
+	if (Properties->TryGetStringField("AddressY", AddressY)) RenderTarget2D->AddressY = FEnumUtilities::GetValue<TextureAddress>(AddressY);
 	FString RenderTargetFormat;
-	if (Properties->TryGetStringField("RenderTargetFormat", RenderTargetFormat)) RenderTarget2D->RenderTargetFormat = static_cast<ETextureRenderTargetFormat>(StaticEnum<ETextureRenderTargetFormat>()->GetValueByNameString(RenderTargetFormat));
+	if (Properties->TryGetStringField("RenderTargetFormat", RenderTargetFormat)) RenderTarget2D->RenderTargetFormat = FEnumUtilities::GetValue<ETextureRenderTargetFormat>(RenderTargetFormat);
 
 	bool bAutoGenerateMips;
 	if (Properties->TryGetBoolField("bAutoGenerateMips", bAutoGenerateMips)) RenderTarget2D->bAutoGenerateMips = bAutoGenerateMips;
 	if (bAutoGenerateMips) {
 		if (FString MipsSamplerFilter; Properties->TryGetStringField("MipsSamplerFilter", MipsSamplerFilter))
-			RenderTarget2D->MipsSamplerFilter = static_cast<TextureFilter>(StaticEnum<TextureFilter>()->GetValueByNameString(MipsSamplerFilter));
+			RenderTarget2D->MipsSamplerFilter = FEnumUtilities::GetValue<TextureFilter>(MipsSamplerFilter);
 	}
 
 	const TSharedPtr<FJsonObject>* ClearColor;
@@ -129,8 +509,8 @@ bool UTextureImporter::ImportTexture2D_Data(UTexture2D* InTexture2D, const TShar
 
 	ImportTexture_Data(InTexture2D, Properties);
 
-	if (FString AddressX; Properties->TryGetStringField("AddressX", AddressX)) InTexture2D->AddressX = static_cast<TextureAddress>(StaticEnum<TextureAddress>()->GetValueByNameString(AddressX));
-	if (FString AddressY; Properties->TryGetStringField("AddressY", AddressY)) InTexture2D->AddressY = static_cast<TextureAddress>(StaticEnum<TextureAddress>()->GetValueByNameString(AddressY));
+	if (FString AddressX; Properties->TryGetStringField("AddressX", AddressX)) InTexture2D->AddressX = FEnumUtilities::GetValue<TextureAddress>(AddressX);
+	if (FString AddressY; Properties->TryGetStringField("AddressY", AddressY)) InTexture2D->AddressY = FEnumUtilities::GetValue<TextureAddress>(AddressY);
 	if (bool bHasBeenPaintedInEditor; Properties->TryGetBoolField("bHasBeenPaintedInEditor", bHasBeenPaintedInEditor)) InTexture2D->bHasBeenPaintedInEditor = bHasBeenPaintedInEditor;
 
 	// --------- Platform Data --------- //
@@ -139,7 +519,7 @@ bool UTextureImporter::ImportTexture2D_Data(UTexture2D* InTexture2D, const TShar
 	if (int SizeX; Properties->TryGetNumberField("SizeX", SizeX)) PlatformData->SizeX = SizeX;
 	if (int SizeY; Properties->TryGetNumberField("SizeY", SizeY)) PlatformData->SizeY = SizeY;
 	if (uint32 PackedData; Properties->TryGetNumberField("PackedData", PackedData)) PlatformData->PackedData = PackedData;
-	if (FString PixelFormat; Properties->TryGetStringField("PixelFormat", PixelFormat)) PlatformData->PixelFormat = static_cast<EPixelFormat>(InTexture2D->GetPixelFormatEnum()->GetValueByNameString(PixelFormat));
+	if (FString PixelFormat; Properties->TryGetStringField("PixelFormat", PixelFormat)) PlatformData->PixelFormat = static_cast<EPixelFormat>(FEnumUtilities::GetValue(InTexture2D->GetPixelFormatEnum(), PixelFormat));
 
 	if (int FirstResourceMemMip; Properties->TryGetNumberField("FirstResourceMemMip", FirstResourceMemMip)) InTexture2D->FirstResourceMemMip = FirstResourceMemMip;
 	if (int LevelIndex; Properties->TryGetNumberField("LevelIndex", LevelIndex)) InTexture2D->LevelIndex = LevelIndex;
@@ -175,27 +555,27 @@ bool UTextureImporter::ImportTexture_Data(UTexture* InTexture, const TSharedPtr<
 
 	if (float CompositePower; Properties->TryGetNumberField("CompositePower", CompositePower)) InTexture->CompositePower = CompositePower;
 	// if (const TSharedPtr<FJsonObject>* CompositeTexture; Properties->TryGetObjectField("CompositeTexture", CompositeTexture));
-	if (FString CompositeTextureMode; Properties->TryGetStringField("CompositeTextureMode", CompositeTextureMode)) InTexture->CompositeTextureMode = static_cast<ECompositeTextureMode>(StaticEnum<ECompositeTextureMode>()->GetValueByNameString(CompositeTextureMode));
+	if (FString CompositeTextureMode; Properties->TryGetStringField("CompositeTextureMode", CompositeTextureMode)) InTexture->CompositeTextureMode = FEnumUtilities::GetValue<ECompositeTextureMode>(CompositeTextureMode);
 
 	if (bool CompressionNoAlpha; Properties->TryGetBoolField("CompressionNoAlpha", CompressionNoAlpha)) InTexture->CompressionNoAlpha = CompressionNoAlpha;
 	if (bool CompressionNone; Properties->TryGetBoolField("CompressionNone", CompressionNone)) InTexture->CompressionNone = CompressionNone;
-	if (FString CompressionQuality; Properties->TryGetStringField("CompressionQuality", CompressionQuality)) InTexture->CompressionQuality = static_cast<ETextureCompressionQuality>(StaticEnum<ETextureCompressionQuality>()->GetValueByNameString(CompressionQuality));
-	if (FString CompressionSettings; Properties->TryGetStringField("CompressionSettings", CompressionSettings)) InTexture->CompressionSettings = static_cast<TextureCompressionSettings>(StaticEnum<TextureCompressionSettings>()->GetValueByNameString(CompressionSettings));
+	if (FString CompressionQuality; Properties->TryGetStringField("CompressionQuality", CompressionQuality)) InTexture->CompressionQuality = FEnumUtilities::GetValue<ETextureCompressionQuality>(CompressionQuality);
+	if (FString CompressionSettings; Properties->TryGetStringField("CompressionSettings", CompressionSettings)) InTexture->CompressionSettings = FEnumUtilities::GetValue<TextureCompressionSettings>(CompressionSettings);
 	if (bool CompressionYCoCg; Properties->TryGetBoolField("CompressionYCoCg", CompressionYCoCg)) InTexture->CompressionYCoCg = CompressionYCoCg;
 	if (bool DeferCompression; Properties->TryGetBoolField("DeferCompression", DeferCompression)) InTexture->DeferCompression = DeferCompression;
-	if (FString Filter; Properties->TryGetStringField("Filter", Filter)) InTexture->Filter = static_cast<TextureFilter>(StaticEnum<TextureFilter>()->GetValueByNameString(Filter));
+	if (FString Filter; Properties->TryGetStringField("Filter", Filter)) InTexture->Filter = FEnumUtilities::GetValue<TextureFilter>(Filter);
 
 	// TODO: Add LayerFormatSettings
 
-	if (FString LODGroup; Properties->TryGetStringField("LODGroup", LODGroup)) InTexture->LODGroup = static_cast<TextureGroup>(StaticEnum<TextureGroup>()->GetValueByNameString(LODGroup));
-	if (FString LossyCompressionAmount; Properties->TryGetStringField("LossyCompressionAmount", LossyCompressionAmount)) InTexture->LossyCompressionAmount = static_cast<ETextureLossyCompressionAmount>(StaticEnum<ETextureLossyCompressionAmount>()->GetValueByNameString(LossyCompressionAmount));
+	if (FString LODGroup; Properties->TryGetStringField("LODGroup", LODGroup)) InTexture->LODGroup = FEnumUtilities::GetValue<TextureGroup>(LODGroup);
+	if (FString LossyCompressionAmount; Properties->TryGetStringField("LossyCompressionAmount", LossyCompressionAmount)) InTexture->LossyCompressionAmount = FEnumUtilities::GetValue<ETextureLossyCompressionAmount>(LossyCompressionAmount);
 
 	if (int MaxTextureSize; Properties->TryGetNumberField("MaxTextureSize", MaxTextureSize)) InTexture->MaxTextureSize = MaxTextureSize;
-	if (FString MipGenSettings; Properties->TryGetStringField("MipGenSettings", MipGenSettings)) InTexture->MipGenSettings = static_cast<TextureMipGenSettings>(StaticEnum<TextureMipGenSettings>()->GetValueByNameString(MipGenSettings));
-	if (FString MipLoadOptions; Properties->TryGetStringField("MipLoadOptions", MipLoadOptions)) InTexture->MipLoadOptions = static_cast<ETextureMipLoadOptions>(StaticEnum<ETextureMipLoadOptions>()->GetValueByNameString(MipLoadOptions));
+	if (FString MipGenSettings; Properties->TryGetStringField("MipGenSettings", MipGenSettings)) InTexture->MipGenSettings = FEnumUtilities::GetValue<TextureMipGenSettings>(MipGenSettings);
+	if (FString MipLoadOptions; Properties->TryGetStringField("MipLoadOptions", MipLoadOptions)) InTexture->MipLoadOptions = FEnumUtilities::GetValue<ETextureMipLoadOptions>(MipLoadOptions);
 
 	if (const TSharedPtr<FJsonObject>* PaddingColor; Properties->TryGetObjectField("PaddingColor", PaddingColor)) InTexture->PaddingColor = FMathUtilities::ObjectToColor(PaddingColor->Get());
-	if (FString PowerOfTwoMode; Properties->TryGetStringField("PowerOfTwoMode", PowerOfTwoMode)) InTexture->PowerOfTwoMode = static_cast<ETexturePowerOfTwoSetting::Type>(StaticEnum<ETexturePowerOfTwoSetting::Type>()->GetValueByNameString(PowerOfTwoMode));
+	if (FString PowerOfTwoMode; Properties->TryGetStringField("PowerOfTwoMode", PowerOfTwoMode)) InTexture->PowerOfTwoMode = FEnumUtilities::GetValue<ETexturePowerOfTwoSetting::Type>(PowerOfTwoMode);
 
 	if (bool SRGB; Properties->TryGetBoolField("SRGB", SRGB)) InTexture->SRGB = SRGB;
 	if (bool VirtualTextureStreaming; Properties->TryGetBoolField("VirtualTextureStreaming", VirtualTextureStreaming)) InTexture->VirtualTextureStreaming = VirtualTextureStreaming;
@@ -205,41 +585,91 @@ bool UTextureImporter::ImportTexture_Data(UTexture* InTexture, const TSharedPtr<
 	return false;
 }
 
-void UTextureImporter::GetDecompressedTextureData(uint8* Data, uint8*& OutData, const int SizeX, const int SizeY, const int TotalSize, const EPixelFormat Format) const {
-	if (Format == PF_BC7) {
-		detexTexture Texture;
-		Texture.data = Data;
-		Texture.format = DETEX_TEXTURE_FORMAT_BPTC;
-		Texture.width = SizeX;
-		Texture.height = SizeY;
-		Texture.width_in_blocks = SizeX / 4;
-		Texture.height_in_blocks = SizeY / 4;
-		detexDecompressTextureLinear(&Texture, OutData, DETEX_PIXEL_FORMAT_BGRA8);
-	} else if (Format == PF_BC6H) {
-		detexTexture Texture;
-		Texture.data = Data;
-		Texture.format = DETEX_TEXTURE_FORMAT_BPTC_FLOAT;
-		Texture.width = SizeX;
-		Texture.height = SizeY;
-		Texture.width_in_blocks = SizeX / 4;
-		Texture.height_in_blocks = SizeY / 4;
-		detexDecompressTextureLinear(&Texture, OutData, DETEX_PIXEL_FORMAT_BGRA8);
-	} else if (Format == PF_G8) {
-		const uint8* s = Data;
-		uint8* d = OutData;
-		for (int i = 0; i < SizeX * SizeY; i++) {
-			const uint8 b = *s++;
-			*d++ = b;
-			*d++ = b;
-			*d++ = b;
-			*d++ = 255;
-		}
-	} else if (Format == PF_B8G8R8A8 || Format == PF_FloatRGBA || Format == PF_G16) {
-		FMemory::Memcpy(OutData, Data, TotalSize);
-	} else {
-		nv::DDSHeader Header;
-		nv::Image Image;
+bool UTextureImporter::GetDecompressedTextureData(const uint8* Data, uint8* OutData, const int SizeX, const int SizeY, const int64 TotalSize, const EPixelFormat Format) {
+	// Only block compressed formats are worth caching, the rest is a copy or a swizzle
+	const int64 PlatformSize = GetPlatformSliceSize(SizeX, SizeY, Format);
+	const bool bUseCache = GPixelFormats[Format].BlockSizeX > 1 && PlatformSize > 0 && IsTextureCacheEnabled();
+
+	uint64 CacheKey = 0;
+	if (bUseCache) {
+		CacheKey = GetTextureCacheKey(Data, PlatformSize, SizeX, SizeY, Format);
+
+		if (LoadCachedTexture(CacheKey, OutData, TotalSize))
+			return true;
+	}
+
+	if (!DecodePlatformData(Data, OutData, SizeX, SizeY, TotalSize, Format))
+		return false;
+
+	if (bUseCache)
+		StoreCachedTexture(CacheKey, OutData, TotalSize);
+
+	return true;
+}
+
+bool UTextureImporter::DecodePlatformData(const uint8* Data, uint8* OutData, const int SizeX, const int SizeY, const int64 TotalSize, const EPixelFormat Format) {
+	// Formats decoded by detex (BC1-BC5, BPTC, and ETC/EAC from mobile builds)
+	uint32 DetexFormat = 0;
+	switch (Format) {
+	case PF_DXT1:
+		DetexFormat = DETEX_TEXTURE_FORMAT_BC1;
+		break;
+	case PF_DXT3:
+		DetexFormat = DETEX_TEXTURE_FORMAT_BC2;
+		break;
+	case PF_DXT5:
+		DetexFormat = DETEX_TEXTURE_FORMAT_BC3;
+		break;
+	case PF_BC4:
+		DetexFormat = DETEX_TEXTURE_FORMAT_RGTC1;
+		break;
+	case PF_BC5:
+		DetexFormat = DETEX_TEXTURE_FORMAT_RGTC2;
+		break;
+	case PF_BC7:
+		DetexFormat = DETEX_TEXTURE_FORMAT_BPTC;
+		break;
+	case PF_BC6H:
+		DetexFormat = DETEX_TEXTURE_FORMAT_BPTC_FLOAT;
+		break;
+	case PF_ETC1:
+		DetexFormat = DETEX_TEXTURE_FORMAT_ETC1;
+		break;
+	case PF_ETC2_RGB:
+		DetexFormat = DETEX_TEXTURE_FORMAT_ETC2;
+		break;
+	case PF_ETC2_RGBA:
+		DetexFormat = DETEX_TEXTURE_FORMAT_ETC2_EAC;
+		break;
+	case PF_ETC2_R11_EAC:
+		DetexFormat = DETEX_TEXTURE_FORMAT_EAC_R11;
+		break;
+	case PF_ETC2_RG11_EAC:
+		DetexFormat = DETEX_TEXTURE_FORMAT_EAC_RG11;
+		break;
+	default: break;
+	}
 
+	// BC1-BC5 can still go through NVTT below, if detex couldn't decode them
+	const bool bHasNVTTFallback = Format == PF_DXT1 || Format == PF_DXT3 || Format == PF_DXT5 || Format == PF_BC4 || Format == PF_BC5;
+
+	if (DetexFormat != 0) {
+		// BC6H stays in half-float, the rest is decoded to 8-bit
+		const uint32 DetexPixelFormat = Format == PF_BC6H ? DETEX_PIXEL_FORMAT_FLOAT_RGBA16 : DETEX_PIXEL_FORMAT_BGRA8;
+
+		// BC5 is a normal map, Z is rebuilt from X and Y like NVTT does
+		const uint32 DetexFlags = Format == PF_BC5 ? DETEX_DECOMPRESS_FLAG_NORMAL_Z : 0;
+
+		if (DecodeDetex(Data, OutData, SizeX, SizeY, DetexFormat, DetexPixelFormat, DetexFlags))
+			return true;
+
+		if (!bHasNVTTFallback)
+			return false;
+	}
+
+	if (Format == PF_A32B32G32R32F) {
+		ConvertFloatToHalf(reinterpret_cast<const float*>(Data), reinterpret_cast<uint16*>(OutData), static_cast<int64>(SizeX) * SizeY * 4);
+	} else if (!ConvertUncompressed(Data, OutData, static_cast<int64>(SizeX) * SizeY, Format)) {
 		uint FourCC;
 		switch (Format) {
 		case PF_BC4:
@@ -260,13 +690,20 @@ void UTextureImporter::GetDecompressedTextureData(uint8* Data, uint8*& OutData,
 		default: FourCC = 0;
 		}
 
+		// Nothing decodes it (ASTC, PVRTC...), better no texture than garbage in it (and in the cache)
+		if (FourCC == 0) {
+			UE_LOG(LogJson, Error, TEXT("No decoder for %s"), GetPixelFormatString(Format));
+			return false;
+		}
+
+		nv::DDSHeader Header;
 		Header.setFourCC(FourCC);
 		Header.setWidth(SizeX);
 		Header.setHeight(SizeY);
 		Header.setNormalFlag(Format == PF_BC5);
-		DecodeDDS(Data, SizeX, SizeY, Header, Image);
 
-		// Fallback to raw data
-		FMemory::Memcpy(OutData, Image.pixels(), TotalSize);
+		return DecodeDDS(Data, static_cast<uint32>(GetPlatformSliceSize(SizeX, SizeY, Format)), Header, OutData);
 	}
+
+	return true;
 }
@@ -15,17 +15,18 @@
 #include "ToolMenus.h"
 #include "LevelEditor.h"
 
-#include "Windows/MinWindows.h"
-
 #include "Interfaces/IPluginManager.h"
 #include "Settings/JsonAsAssetSettings.h"
 #include "Importers/Importer.h"
+#include "Utilities/ClassUtilities.h"
+#include "Utilities/TextureDecode/TextureAllocator.h"
 
 #include "HttpModule.h"
 
 #include "Widgets/Notifications/SNotificationList.h"
 #include "Framework/Notifications/NotificationManager.h"
 #include "IMessageLogListing.h"
+#include "Logging/MessageLog.h"
 
 #include "Dialogs/Dialogs.h"
 #include "ISettingsModule.h"
@@ -33,6 +34,9 @@
 #include "MessageLog/Public/MessageLogInitializationOptions.h"
 #include "MessageLog/Public/MessageLogModule.h"
 #include "Utilities/RemoteUtilities.h"
+#include "Utilities/PrefetchUtilities.h"
+#include "Utilities/ImportJob.h"
+#include "Utilities/LocalFetchProcess.h"
 
 #include "Importers/MaterialFunctionImporter.h"
 
@@ -55,7 +59,6 @@
 #include "Styling/StyleColors.h"
 #include "Styling/AppStyle.h"
 #include "SPrimaryButton.h"
-#include <TlHelp32.h>
 
 #ifdef _MSC_VER
 #undef GetObject
@@ -65,16 +68,17 @@
 
 #define LOCTEXT_NAMESPACE "FJsonAsAssetModule"
 
-#if PLATFORM_WINDOWS
 static TWeakPtr<SNotificationItem> ImportantNotificationPtr;
 static TWeakPtr<SNotificationItem> LocalFetchNotificationPtr;
-#endif
 
 void FJsonAsAssetModule::StartupModule() {
 	FJsonAsAssetStyle::Initialize();
 	FJsonAsAssetStyle::ReloadTextures();
 	FJsonAsAssetCommands::Register();
 
+	InstallDecoderAllocators();
+	FClassUtilities::Initialize();
+
 	PluginCommands = MakeShareable(new FUICommandList);
 	PluginCommands->MapAction(
 		FJsonAsAssetCommands::Get().PluginAction,
@@ -140,6 +144,9 @@ void FJsonAsAssetModule::StartupModule() {
 
 	FPropertyEditorModule& PropertyModule = FModuleManager::GetModuleChecked<FPropertyEditorModule>("PropertyEditor");
 	PropertyModule.RegisterCustomClassLayout(UJsonAsAssetSettings::StaticClass()->GetFName(), FOnGetDetailCustomizationInstance::CreateStatic(&FJsonAsAssetSettingsDetails::MakeInstance));
+
+	// Cached readiness for the toolbar and imports, nothing checks the API on demand
+	FLocalFetchProcess::StartPolling();
 }
 
 void FJsonAsAssetModule::ShutdownModule() {
@@ -148,10 +155,16 @@ void FJsonAsAssetModule::ShutdownModule() {
 	FJsonAsAssetStyle::Shutdown();
 	FJsonAsAssetCommands::Unregister();
 
+	UninstallDecoderAllocators();
+	FClassUtilities::Shutdown();
+
 	if (FModuleManager::Get().IsModuleLoaded("MessageLog")) {
 		FMessageLogModule& MessageLogModule = FModuleManager::GetModuleChecked<FMessageLogModule>("MessageLog");
 		MessageLogModule.UnregisterLogListing("JsonAsAsset");
 	}
+
+	// Left running, the next editor session reuses it
+	FLocalFetchProcess::Shutdown();
 }
 
 void FJsonAsAssetModule::PluginButtonClicked() {
@@ -170,7 +183,7 @@ void FJsonAsAssetModule::PluginButtonClicked() {
 
 		bool bIsLocalHost = Settings->Url.StartsWith("http://localhost");
 
-		if (!IsProcessRunning("JsonAsAssetAPI.exe") && bIsLocalHost) {
+		if (bIsLocalHost && !FLocalFetchProcess::IsReady()) {
 			FNotificationInfo Info(LOCTEXT("JsonAsAssetNotificationTitle", "Local Fetch API"));
 			Info.SubText = LOCTEXT("JsonAsAssetNotificationText",
 				"Please start the Local Fetch API to use JsonAsAsset with no issues, if you need any assistance figuring out Local Fetch and the settings, please take a look at the documentation:"
@@ -200,20 +213,7 @@ void FJsonAsAssetModule::PluginButtonClicked() {
 							LocalFetchNotificationPtr.Reset();
 						}
 
-						FString PluginBinariesFolder;
-
-						const TSharedPtr<IPlugin> PluginInfo = IPluginManager::Get().FindPlugin("JsonAsAsset");
-						if (PluginInfo.IsValid()) {
-							const FString PluginBaseDir = PluginInfo->GetBaseDir();
-							PluginBinariesFolder = FPaths::Combine(PluginBaseDir, TEXT("Binaries"));
-
-							if (!FPaths::DirectoryExists(PluginBinariesFolder)) {
-								PluginBinariesFolder = FPaths::Combine(PluginBaseDir, TEXT("JsonAsAsset/Binaries"));
-							}
-						}
-
-						FString FullPath = FPaths::ConvertRelativePathToFull(PluginBinariesFolder + "/Win64/JsonAsAsset_API/JsonAsAssetAPI.exe");
-						FPlatformProcess::LaunchFileInDefaultExternalApplication(*FullPath, TEXT("--urls=http://localhost:1500/"), ELaunchVerb::Open);
+						FLocalFetchProcess::Start();
 					})
 				)
 			);
@@ -230,15 +230,74 @@ void FJsonAsAssetModule::PluginButtonClicked() {
 	if (OutFileNames.Num() == 0)
 		return;
 
-	for (FString& File : OutFileNames) {
-		// Clear Message Log
+	// Cancelable, and resumes if the same files were canceled (or crashed) before
+	FImportJob Job(OutFileNames);
+
+	// Measured without garbage, what's left after the batch is what it retained
+	CollectGarbage(GARBAGE_OBJECT_FLAGS);
+	const uint64 UsedPhysicalBefore = FPlatformMemory::GetStats().UsedPhysical;
+
+	// Clear Message Log, once per batch so the textures finishing at the end still show next to their files
+	{
 		FMessageLogModule& MessageLogModule = FModuleManager::GetModuleChecked<FMessageLogModule>("MessageLog");
 		TSharedRef<IMessageLogListing> LogListing = (MessageLogModule.GetLogListing("JsonAsAsset"));
 		LogListing->ClearMessages();
+	}
+
+	if (Job.GetNumResumed() > 0) {
+		const FString Message = FString::Printf(TEXT("Resuming import, %d exports were already imported"), Job.GetNumResumed());
+
+		UE_LOG(LogJson, Log, TEXT("%s"), *Message);
+		FMessageLog(FName("JsonAsAsset")).Info(FText::FromString(Message));
+	}
+
+	{
+		// Prefetches are shared by every file of the batch, and dropped once it's done
+		const FPrefetchUtilities::FBatchScope PrefetchScope;
+
+		for (FString& File : OutFileNames) {
+			if (Job.ShouldCancel())
+				break;
+
+			Job.EnterFile(File);
+
+			// Import asset by IImporter
+			IImporter Importer;
+			Importer.ImportReference(File);
+		}
+	}
+
+	/*
+	* Memory report, taken once the batch's texture imports finished (the scope above waits for them)
+	* and garbage is collected. Retained memory should settle across batches, with no importers left
+	* alive. Still the whole process, anything else the editor kept in the meantime is counted too.
+	*/
+	{
+		CollectGarbage(GARBAGE_OBJECT_FLAGS);
 
-		// Import asset by IImporter
-		IImporter* Importer = new IImporter();
-		Importer->ImportReference(File);
+		const uint64 UsedPhysicalAfter = FPlatformMemory::GetStats().UsedPhysical;
+		const double RetainedMB = (static_cast<int64>(UsedPhysicalAfter) - static_cast<int64>(UsedPhysicalBefore)) / (1024.0 * 1024.0);
+
+		NumBatches++;
+
+		const FString Report = FString::Printf(TEXT("Batch %d (%d file(s)): retained %.2f MB (previous batch: %.2f MB), %.2f MB in use, %d importer(s) alive"),
+			NumBatches, OutFileNames.Num(), RetainedMB, LastRetainedMB, UsedPhysicalAfter / (1024.0 * 1024.0), IImporter::GetNumLiveImporters()
+		);
+
+		LastRetainedMB = RetainedMB;
+
+		UE_LOG(LogJson, Log, TEXT("%s"), *Report);
+		FMessageLog(FName("JsonAsAsset")).Info(FText::FromString(Report));
+	}
+
+	if (Job.WasCanceled()) {
+		FNotificationInfo Info(LOCTEXT("ImportCanceledTitle", "Import Canceled"));
+		Info.SubText = LOCTEXT("ImportCanceledText", "Import the same files again to continue where it left off.");
+		Info.ExpireDuration = 5.0f;
+		Info.bUseLargeFont = false;
+		Info.Image = FJsonAsAssetStyle::Get().GetBrush("JsonAsAsset.PluginAction");
+
+		FSlateNotificationManager::Get().AddNotification(Info);
 	}
 }
 
@@ -288,33 +347,6 @@ TArray<FString> FJsonAsAssetModule::OpenFileDialog(FString Title, FString Type)
 	return ReturnValue;
 }
 
-bool FJsonAsAssetModule::IsProcessRunning(const FString& ProcessName) {
-	bool bIsRunning = false;
-
-	// Convert FString to WCHAR
-	const TCHAR* ProcessNameChar = *ProcessName;
-	const WCHAR* ProcessNameWChar = (const WCHAR*)ProcessNameChar;
-
-	HANDLE hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
-	if (hSnapshot != INVALID_HANDLE_VALUE) {
-		PROCESSENTRY32 ProcessEntry;
-		ProcessEntry.dwSize = sizeof(ProcessEntry);
-
-		if (Process32First(hSnapshot, &ProcessEntry)) {
-			do {
-				if (_wcsicmp(ProcessEntry.szExeFile, ProcessNameWChar) == 0) {
-					bIsRunning = true;
-					break;
-				}
-			} while (Process32Next(hSnapshot, &ProcessEntry));
-		}
-
-		CloseHandle(hSnapshot);
-	}
-
-	return bIsRunning;
-}
-
 TSharedRef<SWidget> FJsonAsAssetModule::CreateToolbarDropdown() {
 	TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin("JsonAsAsset");
 	const UJsonAsAssetSettings* Settings = GetDefault<UJsonAsAssetSettings>();
@@ -418,6 +450,8 @@ TSharedRef<SWidget> FJsonAsAssetModule::CreateToolbarDropdown() {
 					if (Settings->bEnableLocalFetch) {
 						AcceptedTypes.Add("Texture2D");
 						AcceptedTypes.Add("TextureCube");
+						AcceptedTypes.Add("VolumeTexture");
+						AcceptedTypes.Add("Texture2DArray");
 						AcceptedTypes.Add("TextureRenderTarget2D");
 						AcceptedTypes.Add("CurveFloat");
 						AcceptedTypes.Add("CurveLinearColor");
@@ -474,23 +508,10 @@ TSharedRef<SWidget> FJsonAsAssetModule::CreateToolbarDropdown() {
 									LocalFetchNotificationPtr.Reset();
 								}
 
-								FString PluginBinariesFolder;
-
-								const TSharedPtr<IPlugin> PluginInfo = IPluginManager::Get().FindPlugin("JsonAsAsset");
-								if (PluginInfo.IsValid()) {
-									const FString PluginBaseDir = PluginInfo->GetBaseDir();
-									PluginBinariesFolder = FPaths::Combine(PluginBaseDir, TEXT("Binaries"));
-
-									if (!FPaths::DirectoryExists(PluginBinariesFolder)) {
-										PluginBinariesFolder = FPaths::Combine(PluginBaseDir, TEXT("JsonAsAsset/Binaries"));
-									}
-								}
-
-								FString FullPath = FPaths::ConvertRelativePathToFull(PluginBinariesFolder + "/Win64/JsonAsAsset_API/JsonAsAssetAPI.exe");
-								FPlatformProcess::LaunchFileInDefaultExternalApplication(*FullPath, TEXT("--urls=http://localhost:1500/"), ELaunchVerb::Open);
+								FLocalFetchProcess::Start();
 							}),
 							FCanExecuteAction::CreateLambda([this]() {
-								return !IsProcessRunning("JsonAsAssetAPI.exe");
+								return !FLocalFetchProcess::IsReady() && !FLocalFetchProcess::IsLaunched();
 							})
 						)
 					);
@@ -501,36 +522,10 @@ TSharedRef<SWidget> FJsonAsAssetModule::CreateToolbarDropdown() {
 						FSlateIcon(),
 						FUIAction(
 							FExecuteAction::CreateLambda([this]() {
-								FString ProcessName = TEXT("JsonAsAssetAPI.exe");
-								TCHAR* ProcessNameChar = ProcessName.GetCharArray().GetData();
-
-								DWORD ProcessID = 0;
-								HANDLE hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
-								if (hSnapshot != INVALID_HANDLE_VALUE) {
-									PROCESSENTRY32 ProcessEntry;
-									ProcessEntry.dwSize = sizeof(PROCESSENTRY32);
-
-									if (Process32First(hSnapshot, &ProcessEntry)) {
-										do {
-											if (FCString::Stricmp(ProcessEntry.szExeFile, ProcessNameChar) == 0) {
-												ProcessID = ProcessEntry.th32ProcessID;
-												break;
-											}
-										} while (Process32Next(hSnapshot, &ProcessEntry));
-									}
-									CloseHandle(hSnapshot);
-								}
-
-								if (ProcessID != 0) {
-									HANDLE hProcess = OpenProcess(PROCESS_TERMINATE, FALSE, ProcessID);
-									if (hProcess != nullptr) {
-										TerminateProcess(hProcess, 0);
-										CloseHandle(hProcess);
-									}
-								}
+								FLocalFetchProcess::Stop();
 							}),
 							FCanExecuteAction::CreateLambda([this]() {
-								return IsProcessRunning("JsonAsAssetAPI.exe");
+								return FLocalFetchProcess::IsReady() || FLocalFetchProcess::IsLaunched();
 							})
 						)
 					);
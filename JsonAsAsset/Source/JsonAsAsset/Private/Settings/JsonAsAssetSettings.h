@@ -152,6 +152,14 @@ public:
 	UPROPERTY(EditAnywhere, Config, Category = "Behavior|Material")
 		bool bSkipResultNodeConnection;
 
+	/**
+	* When importing a material, material function or material instance,
+	* start loading every referenced asset (exported JSON files, or Local Fetch)
+	* in the background, before the importer reaches them.
+	*/
+	UPROPERTY(EditAnywhere, Config, Category = "Behavior|Material")
+		bool bPrefetchReferences = true;
+
 	/**
 	* Fetches assets from a local service and automatically imports
 	* them into your project, without having them locally
@@ -184,6 +192,29 @@ public:
 	UPROPERTY(EditAnywhere, Config, Category="Local Fetch|Configuration", meta=(EditCondition="bEnableLocalFetch", FilePathFilter="usmap", RelativeToGameDir))
 		FFilePath MappingFilePath;
 
+	/**
+	* Imports textures from a small mip first, so materials and material
+	* instances using them can be imported (and previewed) right away.
+	* The full resolution source replaces it in the background.
+	*/
+	UPROPERTY(EditAnywhere, Config, Category="Local Fetch|Textures", meta=(EditCondition="bEnableLocalFetch"))
+		bool bProxyTextureImport;
+
+	// Largest side of the proxy mip, the first mip that fits is used
+	UPROPERTY(EditAnywhere, Config, Category="Local Fetch|Textures", meta=(EditCondition="bEnableLocalFetch && bProxyTextureImport", ClampMin="16", ClampMax="2048"))
+		int32 ProxyTextureSize = 256;
+
+	/**
+	* Keeps decoded textures on disk (Saved/JsonAsAsset/TextureCache), so
+	* importing the same texture again skips decoding it.
+	*/
+	UPROPERTY(EditAnywhere, Config, Category="Local Fetch|Textures", meta=(EditCondition="bEnableLocalFetch"))
+		bool bCacheDecodedTextures = true;
+
+	// Size of the cache in megabytes, the least recently used textures are removed past it
+	UPROPERTY(EditAnywhere, Config, Category="Local Fetch|Textures", meta=(EditCondition="bEnableLocalFetch && bCacheDecodedTextures", ClampMin="64"))
+		int32 TextureCacheSize = 2048;
+
 	// High res textures
 	UPROPERTY(EditAnywhere, Config, Category="Local Fetch Encryption|Behavior", meta=(EditCondition="bEnableLocalFetch"))
 		bool bUseContentBuilds;
@@ -12,8 +12,11 @@
 
 #include "UObject/SavePackage.h"
 
+#include "HttpManager.h"
 #include "HttpModule.h"
 #include "AssetRegistry/AssetRegistryModule.h"
+#include "Engine/Texture2D.h"
+#include "Engine/TextureCube.h"
 #include "Importers/TextureImporter.h"
 #include "Importers/MaterialParameterCollectionImporter.h"
 #include "Interfaces/IHttpResponse.h"
@@ -21,7 +24,11 @@
 #include "Serialization/JsonSerializer.h"
 #include "Utilities/AssetUtilities.h"
 #include "Utilities/RemoteUtilities.h"
+#include "Utilities/PrefetchUtilities.h"
+#include "Utilities/ImportJob.h"
 #include "PluginUtils.h"
+#include "Async/Async.h"
+#include "Logging/MessageLog.h"
 
 UPackage* FAssetUtilities::CreateAssetPackage(const FString& FullPath) {
 	UPackage* Package = CreatePackage(*FullPath);
@@ -107,36 +114,37 @@ UObject* FAssetUtilities::GetSelectedAsset() {
 	return SelectedAssets[0].GetAsset();
 }
 
+bool FAssetUtilities::SavePackage(UPackage* Package) {
+	const UJsonAsAssetSettings* Settings = GetDefault<UJsonAsAssetSettings>();
+	Package->FullyLoad();
+
+	FSavePackageArgs SaveArgs; {
+		SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+		SaveArgs.SaveFlags = SAVE_NoError;
+	}
+
+	const FString PackageName = Package->GetName();
+	const FString PackageFileName = FPackageName::LongPackageNameToFilename(PackageName, FPackageName::GetAssetPackageExtension());
+
+	if (!Settings->bAllowPackageSaving)
+		return false;
+
+	return UPackage::SavePackage(Package, nullptr, *PackageFileName, SaveArgs);
+}
+
 // Constructing assets ect..
 template <typename T>
 bool FAssetUtilities::ConstructAsset(const FString& Path, const FString& Type, TObjectPtr<T>& OutObject, bool& bSuccess) {
 	// Supported Assets
-	if (Type == "Texture2D" ||
-		Type == "TextureCube" ||
-		Type == "TextureRenderTarget2D" ||
-		Type == "MaterialParameterCollection" ||
-		Type == "CurveFloat" ||
-		Type == "CurveTable" ||
-		Type == "CurveVector" ||
-		Type == "CurveLinearColorAtlas" ||
-		Type == "CurveLinearColor" ||
-		Type == "PhysicalMaterial" ||
-		Type == "SubsurfaceProfile" ||
-		Type == "LandscapeGrassType" ||
-		Type == "MaterialInstanceConstant" ||
-		Type == "ReverbEffect" ||
-		Type == "SoundAttenuation" ||
-		Type == "SoundConcurrency" ||
-		Type == "DataTable" ||
-		Type == "SubsurfaceProfile" ||
-		Type == "MaterialFunction"
-	) {
+	if (CanConstructAsset(Type)) {
 		//		Manually supported asset types
 		// (ex: textures have to be handled separately)
 		if (Type ==
 			"Texture2D" ||
 			Type == "TextureRenderTarget2D" ||
-			Type == "TextureCube"
+			Type == "TextureCube" ||
+			Type == "VolumeTexture" ||
+			Type == "Texture2DArray"
 			) {
 			UTexture* Texture;
 
@@ -169,8 +177,8 @@ bool FAssetUtilities::ConstructAsset(const FString& Path, const FString& Type, T
 				Package->FullyLoad();
 
 				// Import asset by IImporter
-				IImporter* Importer = new IImporter();
-				bSuccess = Importer->HandleExports(Response->GetArrayField("jsonOutput"), PackagePath, true);
+				IImporter Importer;
+				bSuccess = Importer.HandleExports(Response->GetArrayField("jsonOutput"), PackagePath, true);
 
 				// Define found object
 				OutObject = Cast<T>(StaticLoadObject(T::StaticClass(), nullptr, *Path));
@@ -183,6 +191,29 @@ bool FAssetUtilities::ConstructAsset(const FString& Path, const FString& Type, T
 	return false;
 }
 
+bool FAssetUtilities::CanConstructAsset(const FString& Type) {
+	return Type == "Texture2D" ||
+		Type == "TextureCube" ||
+		Type == "VolumeTexture" ||
+		Type == "Texture2DArray" ||
+		Type == "TextureRenderTarget2D" ||
+		Type == "MaterialParameterCollection" ||
+		Type == "CurveFloat" ||
+		Type == "CurveTable" ||
+		Type == "CurveVector" ||
+		Type == "CurveLinearColorAtlas" ||
+		Type == "CurveLinearColor" ||
+		Type == "PhysicalMaterial" ||
+		Type == "SubsurfaceProfile" ||
+		Type == "LandscapeGrassType" ||
+		Type == "MaterialInstanceConstant" ||
+		Type == "ReverbEffect" ||
+		Type == "SoundAttenuation" ||
+		Type == "SoundConcurrency" ||
+		Type == "DataTable" ||
+		Type == "MaterialFunction";
+}
+
 bool FAssetUtilities::Construct_TypeTexture(const FString& Path, UTexture*& OutTexture) {
 	if (Path.IsEmpty()) 
 		return false;
@@ -195,28 +226,10 @@ bool FAssetUtilities::Construct_TypeTexture(const FString& Path, UTexture*& OutT
 	if (Response.IsEmpty())
 		return false;
 
-	const UJsonAsAssetSettings* Settings = GetDefault<UJsonAsAssetSettings>();
 	TSharedPtr<FJsonObject> JsonExport = Response[0]->AsObject();
 	FString Type = JsonExport->GetStringField("Type");
 	UTexture* Texture = nullptr;
 
-	// --------------- Download Texture Data ------------
-	FHttpModule* HttpModule = &FHttpModule::Get();
-	const TSharedRef<IHttpRequest> HttpRequest = HttpModule->CreateRequest();
-
-	HttpRequest->SetURL(Settings->Url + "/api/v1/export?path=" + Path);
-	HttpRequest->SetHeader("content-type", "application/octet-stream");
-	HttpRequest->SetVerb(TEXT("GET"));
-
-	const TSharedPtr<IHttpResponse> HttpResponse = FRemoteUtilities::ExecuteRequestSync(HttpRequest);
-	if (!HttpResponse.IsValid() || HttpResponse->GetResponseCode() != 200)
-		return false;
-
-	TArray<uint8> Data = HttpResponse->GetContent();
-	if (Data.Num() == 0)
-		return false;
-	// --------------- Download Texture Data ------------
-
 	FString PackagePath; FString AssetName; {
 		Path.Split(".", &PackagePath, &AssetName);
 	}
@@ -226,14 +239,21 @@ bool FAssetUtilities::Construct_TypeTexture(const FString& Path, UTexture*& OutT
 	Package->FullyLoad();
 
 	// Create Importer
-	const UTextureImporter* Importer = new UTextureImporter(AssetName, Path, Response[0]->AsObject(), Package, OutermostPkg);
+	const UTextureImporter Importer(AssetName, Path, Response[0]->AsObject(), Package, OutermostPkg);
+
+	// Only the object is created here, the source is decoded on a worker
+	const TSharedRef<FTextureDecodeJob> Job = MakeShared<FTextureDecodeJob>();
 
 	if (Type == "Texture2D")
-		Importer->ImportTexture2D(Texture, Data, JsonExport);
+		Texture = Importer.CreateTexture2D(JsonExport, *Job);
 	if (Type == "TextureCube")
-		Importer->ImportTextureCube(Texture, Data, JsonExport);
+		Texture = Importer.CreateTextureCube(JsonExport, *Job);
+	if (Type == "VolumeTexture")
+		Texture = Importer.CreateVolumeTexture(JsonExport, *Job);
+	if (Type == "Texture2DArray")
+		Texture = Importer.CreateTexture2DArray(JsonExport, *Job);
 	if (Type == "TextureRenderTarget2D")
-		Importer->ImportRenderTarget2D(Texture, JsonExport->GetObjectField("Properties"));
+		Importer.ImportRenderTarget2D(Texture, JsonExport->GetObjectField("Properties"));
 
 	if (Texture == nullptr)
 		return false;
@@ -243,27 +263,254 @@ bool FAssetUtilities::Construct_TypeTexture(const FString& Path, UTexture*& OutT
 		return false;
 
 	Package->SetDirtyFlag(true);
-	Texture->PostEditChange();
-	Texture->AddToRoot();
 	Package->FullyLoad();
 
-	// Save texture
-	if (Settings->bAllowPackageSaving) {
-		FSavePackageArgs SaveArgs; {
-			SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
-			SaveArgs.SaveFlags = SAVE_NoError;
-		}
+	// Rooted until its source is filled in (see FinishTextureImport), and waited on by the batch
+	Texture->AddToRoot();
+	NumPendingTextureImports++;
 
-		const FString PackageName = Package->GetName();
-		const FString PackageFileName = FPackageName::LongPackageNameToFilename(PackageName, FPackageName::GetAssetPackageExtension());
-		UPackage::SavePackage(Package, nullptr, *PackageFileName, SaveArgs);
+	OutTexture = Texture;
+
+	// Render targets have no source data
+	if (Type == "TextureRenderTarget2D") {
+		FinishTextureImport(Texture, Path);
+
+		return true;
 	}
 
-	OutTexture = Texture;
+	ImportTextureDataAsync(Texture, Path, Job);
 
 	return true;
 }
 
+void FAssetUtilities::ImportTextureDataAsync(UTexture* Texture, const FString& Path, const TSharedRef<FTextureDecodeJob>& Job) {
+	const UJsonAsAssetSettings* Settings = GetDefault<UJsonAsAssetSettings>();
+	const FString URL = Settings->Url + "/api/v1/export?path=" + Path;
+
+	// Small mip first, so materials can use the texture right away (not worth it if the full data was prefetched)
+	if (Settings->bProxyTextureImport && Texture->IsA<UTexture2D>() && !FPrefetchUtilities::HasRequest(URL)) {
+		const TWeakObjectPtr<UTexture> WeakTexture = Texture;
+
+		RequestTextureData(URL + "&maxSize=" + FString::FromInt(Settings->ProxyTextureSize), [WeakTexture, Path, Job](const FHttpResponsePtr& HttpResponse) {
+			if (UTexture* Texture = WeakTexture.Get())
+				ImportProxyTextureData(Texture, Path, Job, HttpResponse);
+			else
+				FailTextureImport(nullptr, Path);
+		});
+
+		return;
+	}
+
+	ImportFullTextureData(Texture, Path, Job);
+}
+
+void FAssetUtilities::ImportProxyTextureData(UTexture* Texture, const FString& Path, const TSharedRef<FTextureDecodeJob>& Job, const FHttpResponsePtr& HttpResponse) {
+	if (!HttpResponse.IsValid() || HttpResponse->GetResponseCode() != 200 || HttpResponse->GetContent().Num() == 0) {
+		ImportFullTextureData(Texture, Path, Job);
+		return;
+	}
+
+	int32 MipSizeX, MipSizeY;
+
+	// An API without proxy support sends the first mip, which is all we need
+	if (!GetResponseMipSize(HttpResponse, MipSizeX, MipSizeY) || (MipSizeX == Job->SizeX && MipSizeY == Job->SizeY)) {
+		DecodeTextureData(Texture, Path, Job, HttpResponse, [Path](UTexture* DecodedTexture) {
+			FinishTextureImport(DecodedTexture, Path);
+		});
+
+		return;
+	}
+
+	const TSharedRef<FTextureDecodeJob> ProxyJob = MakeShared<FTextureDecodeJob>(*Job);
+	ProxyJob->SizeX = MipSizeX;
+	ProxyJob->SizeY = MipSizeY;
+
+	DecodeTextureData(Texture, Path, ProxyJob, HttpResponse, [Path, Job](UTexture* DecodedTexture) {
+		// Usable from here on, the full resolution source replaces the proxy once it's in
+		DecodedTexture->PostEditChange();
+
+		UE_LOG(LogJson, Log, TEXT("Imported %s from a %dx%d proxy, full resolution (%dx%d) follows"), *Path, DecodedTexture->Source.GetSizeX(), DecodedTexture->Source.GetSizeY(), Job->SizeX, Job->SizeY);
+
+		ImportFullTextureData(DecodedTexture, Path, Job, true);
+	});
+}
+
+void FAssetUtilities::ImportFullTextureData(UTexture* Texture, const FString& Path, const TSharedRef<FTextureDecodeJob>& Job, const bool bHasProxy) {
+	const UJsonAsAssetSettings* Settings = GetDefault<UJsonAsAssetSettings>();
+	const TWeakObjectPtr<UTexture> WeakTexture = Texture;
+
+	RequestTextureData(Settings->Url + "/api/v1/export?path=" + Path, [WeakTexture, Path, Job, bHasProxy](const FHttpResponsePtr& HttpResponse) {
+		UTexture* Texture = WeakTexture.Get();
+		if (Texture == nullptr) {
+			FailTextureImport(nullptr, Path);
+			return;
+		}
+
+		if (!HttpResponse.IsValid() || HttpResponse->GetResponseCode() != 200 || HttpResponse->GetContent().Num() == 0) {
+			const FString Message = bHasProxy
+				? "Failed to download full resolution texture data, saved at proxy resolution: " + Path
+				: "Failed to download texture data: " + Path;
+
+			UE_LOG(LogJson, Error, TEXT("%s"), *Message);
+			FMessageLog(FName("JsonAsAsset")).Error(FText::FromString(Message));
+
+			FNotificationInfo Info(FText::FromString(bHasProxy ? "Texture Saved at Proxy Resolution" : "Texture Download Failed"));
+			Info.SubText = FText::FromString(Path);
+			Info.ExpireDuration = 5.0f;
+			Info.bUseLargeFont = false;
+
+			FSlateNotificationManager::Get().AddNotification(Info)->SetCompletionState(SNotificationItem::CS_Fail);
+
+			// The proxy is a usable texture, better saved than left unsaved in memory
+			if (bHasProxy)
+				FinishTextureImport(Texture, Path, false);
+			else
+				FailTextureImport(Texture, Path);
+
+			return;
+		}
+
+		// Sized from what the API sent, the first mip with data can be smaller than the export's size (cubes are sent as one tall image)
+		if (int32 MipSizeX, MipSizeY; !Texture->IsA<UTextureCube>() && GetResponseMipSize(HttpResponse, MipSizeX, MipSizeY) && (MipSizeX != Job->SizeX || MipSizeY != Job->SizeY)) {
+			UE_LOG(LogJson, Log, TEXT("Texture data of \"%s\" is %dx%d, not %dx%d"), *Path, MipSizeX, MipSizeY, Job->SizeX, Job->SizeY);
+
+			Job->SizeX = MipSizeX;
+			Job->SizeY = MipSizeY;
+		}
+
+		DecodeTextureData(Texture, Path, Job, HttpResponse, [Path](UTexture* DecodedTexture) {
+			FinishTextureImport(DecodedTexture, Path);
+		});
+	});
+}
+
+void FAssetUtilities::DecodeTextureData(UTexture* Texture, const FString& Path, const TSharedRef<FTextureDecodeJob>& Job, const FHttpResponsePtr& HttpResponse, TFunction<void(UTexture*)>&& OnDecoded) {
+	const TWeakObjectPtr<UTexture> WeakTexture = Texture;
+
+	// Source allocated and locked here, the worker decodes straight into it. The texture is rooted
+	// until FinishTextureImport, so the locked mip stays valid even if the import is abandoned
+	UTextureImporter::BeginDecode(Texture, *Job, HttpResponse->GetContent().Num());
+
+	// The response is kept alive instead of copying its content for the worker
+	Async(EAsyncExecution::ThreadPool, [WeakTexture, Path, Job, HttpResponse, OnDecoded = MoveTemp(OnDecoded)]() mutable {
+		UTextureImporter::DecodeTexture(*Job, HttpResponse->GetContent());
+
+		AsyncTask(ENamedThreads::GameThread, [WeakTexture, Path, Job, OnDecoded = MoveTemp(OnDecoded)]() {
+			UTexture* Texture = WeakTexture.Get();
+			if (Texture == nullptr) {
+				FailTextureImport(nullptr, Path);
+				return;
+			}
+
+			// Not saved, a failed decode would only leave an empty source in the package
+			if (!UTextureImporter::FinalizeTexture(Texture, *Job)) {
+				UE_LOG(LogJson, Error, TEXT("Failed to decode texture data for \"%s\""), *Texture->GetPathName());
+				FMessageLog(FName("JsonAsAsset")).Error(FText::FromString("Failed to decode texture data: " + Texture->GetPathName()));
+
+				FailTextureImport(Texture, Path);
+				return;
+			}
+
+			OnDecoded(Texture);
+		});
+	});
+}
+
+bool FAssetUtilities::GetResponseMipSize(const FHttpResponsePtr& HttpResponse, int32& OutSizeX, int32& OutSizeY) {
+	OutSizeX = FCString::Atoi(*HttpResponse->GetHeader("X-Mip-SizeX"));
+	OutSizeY = FCString::Atoi(*HttpResponse->GetHeader("X-Mip-SizeY"));
+
+	return OutSizeX > 0 && OutSizeY > 0;
+}
+
+void FAssetUtilities::RequestTextureData(const FString& URL, TFunction<void(const FHttpResponsePtr&)>&& OnDataDownloaded) {
+	TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> HttpRequest = FPrefetchUtilities::TakeRequest(URL);
+
+	if (!HttpRequest.IsValid()) {
+		HttpRequest = FHttpModule::Get().CreateRequest();
+
+		HttpRequest->SetURL(URL);
+		HttpRequest->SetHeader("content-type", "application/octet-stream");
+		HttpRequest->SetVerb(TEXT("GET"));
+	}
+
+	const TSharedRef<TFunction<void(const FHttpResponsePtr&)>> Callback = MakeShared<TFunction<void(const FHttpResponsePtr&)>>(MoveTemp(OnDataDownloaded));
+
+	// Bound before the status is checked, a prefetched request finishing in between still calls back
+	HttpRequest->OnProcessRequestComplete().BindLambda([Callback](FHttpRequestPtr, FHttpResponsePtr HttpResponse, bool) {
+		(*Callback)(HttpResponse);
+	});
+
+	const EHttpRequestStatus::Type Status = HttpRequest->GetStatus();
+
+	if (Status == EHttpRequestStatus::NotStarted) {
+		if (!HttpRequest->ProcessRequest()) {
+			HttpRequest->OnProcessRequestComplete().Unbind();
+			(*Callback)(nullptr);
+		}
+	} else if (Status != EHttpRequestStatus::Processing) {
+		// Prefetched, and already finished (its completion went out before anything was bound)
+		HttpRequest->OnProcessRequestComplete().Unbind();
+		(*Callback)(HttpRequest->GetResponse());
+	}
+}
+
+void FAssetUtilities::FinishTextureImport(UTexture* Texture, const FString& Path, const bool bComplete) {
+	Texture->PostEditChange();
+	Texture->RemoveFromRoot();
+
+	const bool bSaved = SavePackage(Texture->GetPackage());
+	NumPendingTextureImports--;
+
+	if (!bComplete) {
+		FailedTextureImports.Add(Path);
+		return;
+	}
+
+	NumTextureImports++;
+
+	// Only what's on disk can be skipped when the batch is resumed
+	if (FImportJob* Job = FImportJob::Get(); Job != nullptr && bSaved)
+		Job->Commit(Path, Texture->GetName(), Texture->GetPackage()->GetName());
+}
+
+void FAssetUtilities::FailTextureImport(UTexture* Texture, const FString& Path) {
+	if (Texture != nullptr)
+		Texture->RemoveFromRoot();
+
+	NumPendingTextureImports--;
+	FailedTextureImports.Add(Path);
+}
+
+void FAssetUtilities::WaitForTextureImports() {
+	double LastTime = FPlatformTime::Seconds();
+
+	// Downloads complete on HTTP ticks, decodes hand their textures back as game thread tasks
+	while (NumPendingTextureImports > 0) {
+		const double AppTime = FPlatformTime::Seconds();
+		FHttpModule::Get().GetHttpManager().Tick(AppTime - LastTime);
+		LastTime = AppTime;
+
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+		FPlatformProcess::Sleep(0.01f);
+	}
+
+	if (NumTextureImports == 0 && FailedTextureImports.IsEmpty())
+		return;
+
+	const FString Report = FString::Printf(TEXT("%d texture(s) imported in the background, %d failed"), NumTextureImports, FailedTextureImports.Num());
+	UE_LOG(LogJson, Log, TEXT("%s"), *Report);
+
+	FMessageLog MessageLogger = FMessageLog(FName("JsonAsAsset"));
+	MessageLogger.Info(FText::FromString(Report));
+
+	for (const FString& Path : FailedTextureImports)
+		MessageLogger.Error(FText::FromString("Texture not fully imported: " + Path));
+
+	NumTextureImports = 0;
+	FailedTextureImports.Empty();
+}
+
 void FAssetUtilities::CreatePlugin(FString PluginName) {
 	FPluginUtils::FNewPluginParamsWithDescriptor CreationParams;
 	CreationParams.Descriptor.bCanContainContent = true;
@@ -311,11 +558,17 @@ const TSharedPtr<FJsonObject> FAssetUtilities::API_RequestExports(const FString&
 
 	const UJsonAsAssetSettings* Settings = GetDefault<UJsonAsAssetSettings>();
 
-	const TSharedRef<IHttpRequest> NewRequest = HttpModule->CreateRequest();
-	NewRequest->SetURL(Settings->Url + "/api/v1/export?raw=true&path=" + Path);
-	NewRequest->SetVerb(TEXT("GET"));
+	const FString URL = Settings->Url + "/api/v1/export?raw=true&path=" + Path;
+	TSharedPtr<IHttpResponse> NewResponse = FPrefetchUtilities::TakeResponse(URL);
+
+	if (!NewResponse.IsValid()) {
+		const TSharedRef<IHttpRequest> NewRequest = HttpModule->CreateRequest();
+		NewRequest->SetURL(URL);
+		NewRequest->SetVerb(TEXT("GET"));
+
+		NewResponse = FRemoteUtilities::ExecuteRequestSync(NewRequest);
+	}
 
-	const TSharedPtr<IHttpResponse> NewResponse = FRemoteUtilities::ExecuteRequestSync(NewRequest);
 	if (!NewResponse.IsValid()) return TSharedPtr<FJsonObject>();
 
 	const TSharedRef<TJsonReader<>> JsonReader = TJsonReaderFactory<>::Create(NewResponse->GetContentAsString());
@@ -0,0 +1,95 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Utilities/ClassUtilities.h"
+
+#include "UObject/LinkerLoad.h"
+
+FRWLock FClassUtilities::Lock;
+TMap<FName, TWeakObjectPtr<UClass>> FClassUtilities::Classes;
+FDelegateHandle FClassUtilities::ModulesChangedHandle;
+
+// Packages whose class redirects are checked for renamed types
+static const TCHAR* RedirectedPackages[] = {
+	TEXT("/Script/Engine"),
+	TEXT("/Script/InterchangeImport"),
+	TEXT("/Script/Landscape")
+};
+
+// Types renamed without a redirect
+static const TMap<FString, FString> RenamedTypes = {
+	{ TEXT("MaterialExpressionPhysicalMaterialOutput"), TEXT("MaterialExpressionLandscapePhysicalMaterialOutput") }
+};
+
+UClass* FClassUtilities::FindClass(const FName Type) {
+	if (Type.IsNone())
+		return nullptr;
+
+	{
+		FReadScopeLock ReadLock(Lock);
+
+		if (const TWeakObjectPtr<UClass>* Class = Classes.Find(Type)) {
+			if (!Class->IsStale())
+				return Class->Get();
+		}
+	}
+
+	// FindObject and the linker's redirects aren't safe to search from workers
+	check(IsInGameThread());
+
+	UClass* Class = ResolveClass(Type.ToString());
+
+	FWriteScopeLock WriteLock(Lock);
+	Classes.Add(Type, Class);
+
+	return Class;
+}
+
+void FClassUtilities::Initialize() {
+	ModulesChangedHandle = FModuleManager::Get().OnModulesChanged().AddStatic(&FClassUtilities::OnModulesChanged);
+}
+
+void FClassUtilities::Shutdown() {
+	FModuleManager::Get().OnModulesChanged().Remove(ModulesChangedHandle);
+	ModulesChangedHandle.Reset();
+
+	FWriteScopeLock WriteLock(Lock);
+	Classes.Empty();
+}
+
+UClass* FClassUtilities::ResolveClass(const FString& Type) {
+	if (Type.StartsWith(TEXT("/")))
+		return FindObject<UClass>(nullptr, *Type);
+
+	// Most exports are engine classes, found without searching every package
+	if (UClass* Class = FindObject<UClass>(nullptr, *(TEXT("/Script/Engine.") + Type)))
+		return Class;
+
+	if (UClass* Class = FindFirstObject<UClass>(*Type, EFindFirstObjectOptions::NativeFirst))
+		return Class;
+
+	for (const TCHAR* Package : RedirectedPackages) {
+		const FString RedirectedPath = FLinkerLoad::FindNewPathNameForClass(FString(Package) + TEXT(".") + Type, false);
+
+		if (!RedirectedPath.IsEmpty()) {
+			if (UClass* Class = FindObject<UClass>(nullptr, *RedirectedPath))
+				return Class;
+		}
+	}
+
+	if (const FString* RenamedType = RenamedTypes.Find(Type))
+		return ResolveClass(*RenamedType);
+
+	return nullptr;
+}
+
+void FClassUtilities::OnModulesChanged(FName ModuleName, const EModuleChangeReason Reason) {
+	if (Reason != EModuleChangeReason::ModuleLoaded)
+		return;
+
+	FWriteScopeLock WriteLock(Lock);
+
+	for (auto It = Classes.CreateIterator(); It; ++It) {
+		if (!It->Value.IsValid())
+			It.RemoveCurrent();
+	}
+}
@@ -3,6 +3,7 @@
 #include "Utilities/EditorGraph/MaterialGraph_Interface.h"
 
 #include "Dom/JsonObject.h"
+#include "Utilities/ClassUtilities.h"
 #include "Utilities/MathUtilities.h"
 
 // Expressions
@@ -236,27 +237,17 @@ UMaterialExpression* UMaterialGraph_Interface::CreateEmptyExpression(UObject* Pa
 	if (IgnoredExpressions.Contains(Type.ToString())) // Unhandled expressions
 		return nullptr;
 
-	const UClass* Class = FindObject<UClass>(ANY_PACKAGE, *Type.ToString());
-
-	if (!Class) {
-		TArray<FString> Redirects = TArray{
-			FLinkerLoad::FindNewPathNameForClass("/Script/InterchangeImport." + Type.ToString(), false),
-			FLinkerLoad::FindNewPathNameForClass("/Script/Landscape." + Type.ToString(), false)
-		};
-		
-		for (FString RedirectedPath : Redirects) {
-			if (!RedirectedPath.IsEmpty() && !Class)
-				Class = FindObject<UClass>(nullptr, *RedirectedPath);
-		}
+	const UClass* Class = FClassUtilities::FindClass(Type);
 
-		if (!Class) 
-			Class = FindObject<UClass>(ANY_PACKAGE, *Type.ToString().Replace(TEXT("MaterialExpressionPhysicalMaterialOutput"), TEXT("MaterialExpressionLandscapePhysicalMaterialOutput")));
+	if (Class == nullptr || !Class->IsChildOf(UMaterialExpression::StaticClass())) {
+		UE_LOG(LogJson, Warning, TEXT("Skipping expression \"%s\", unknown type %s"), *Name.ToString(), *Type.ToString());
+		return nullptr;
 	}
 
 	return NewObject<UMaterialExpression>
 	(
 		Parent,
-		Class, // Find class using ANY_PACKAGE (may error in the future)
+		Class,
 		Name,
 		RF_Transactional
 	);
@@ -0,0 +1,47 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Utilities/EnumUtilities.h"
+
+FRWLock FEnumUtilities::Lock;
+TMap<TObjectKey<UEnum>, TMap<FString, int64>> FEnumUtilities::Enums;
+
+int64 FEnumUtilities::GetValue(const UEnum* Enum, const FString& Name) {
+	if (Enum == nullptr)
+		return INDEX_NONE;
+
+	const TObjectKey<UEnum> Key(Enum);
+
+	{
+		FReadScopeLock ReadLock(Lock);
+
+		if (const TMap<FString, int64>* Values = Enums.Find(Key)) {
+			if (const int64* Value = Values->Find(Name))
+				return *Value;
+		}
+	}
+
+	FWriteScopeLock WriteLock(Lock);
+	TMap<FString, int64>* Values = Enums.Find(Key);
+
+	if (Values == nullptr) {
+		Values = &Enums.Add(Key);
+
+		for (int32 Index = 0; Index < Enum->NumEnums(); Index++) {
+			const int64 Value = Enum->GetValueByIndex(Index);
+
+			Values->Add(Enum->GetNameByIndex(Index).ToString(), Value);
+			Values->FindOrAdd(Enum->GetNameStringByIndex(Index), Value);
+		}
+
+		if (const int64* Value = Values->Find(Name))
+			return *Value;
+	}
+
+	// Redirected names, remembered so the enum isn't searched again. Unknown ones aren't, the table
+	// would grow with every malformed name it's given
+	const int64 Value = Enum->GetValueByNameString(Name);
+	if (Value != INDEX_NONE)
+		Values->Add(Name, Value);
+
+	return Value;
+}
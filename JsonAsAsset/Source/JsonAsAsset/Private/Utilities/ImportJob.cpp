@@ -0,0 +1,79 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Utilities/ImportJob.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+
+FImportJob* FImportJob::ActiveJob = nullptr;
+
+FImportJob::FImportJob(const TArray<FString>& InFiles)
+	: Files(InFiles),
+	  SlowTask(InFiles.Num(), FText::FromString("Importing JSON files..")) {
+	// The same files (in any order) are the same batch
+	TArray<FString> SortedFiles = Files;
+	SortedFiles.Sort();
+
+	BatchId = FMD5::HashAnsiString(*FString::Join(SortedFiles, TEXT("\n")));
+	JournalPath = FPaths::ProjectSavedDir() / TEXT("JsonAsAsset") / TEXT("ImportJournal.txt");
+
+	// Journal format: batch id, then one "File:Export|Package" line per committed export
+	TArray<FString> Lines;
+	if (FFileHelper::LoadFileToStringArray(Lines, *JournalPath) && Lines.Num() > 0 && Lines[0] == BatchId) {
+		for (int32 i = 1; i < Lines.Num(); i++) {
+			if (FString Key, PackageName; Lines[i].Split("|", &Key, &PackageName, ESearchCase::IgnoreCase, ESearchDir::FromEnd))
+				Committed.Add(Key, PackageName);
+		}
+	} else {
+		FFileHelper::SaveStringToFile(BatchId + LINE_TERMINATOR, *JournalPath);
+	}
+
+	NumResumed = Committed.Num();
+
+	SlowTask.MakeDialog(true);
+	ActiveJob = this;
+}
+
+FImportJob::~FImportJob() {
+	if (ActiveJob == this)
+		ActiveJob = nullptr;
+
+	// Finished, nothing to resume
+	if (!bCanceled)
+		IFileManager::Get().Delete(*JournalPath, false, false, true);
+}
+
+void FImportJob::EnterFile(const FString& File) {
+	SlowTask.EnterProgressFrame(1, FText::FromString("Importing " + FPaths::GetBaseFilename(File)));
+}
+
+bool FImportJob::ShouldCancel() {
+	if (!bCanceled && SlowTask.ShouldCancel())
+		bCanceled = true;
+
+	return bCanceled;
+}
+
+bool FImportJob::IsCommitted(const FString& File, const FString& ExportName) const {
+	const FString* PackageName = Committed.Find(GetKey(File, ExportName));
+	if (PackageName == nullptr)
+		return false;
+
+	// Not saved and not in memory anymore, import it again
+	return FindPackage(nullptr, **PackageName) != nullptr || FPackageName::DoesPackageExist(*PackageName);
+}
+
+void FImportJob::Commit(const FString& File, const FString& ExportName, const FString& PackageName) {
+	const FString Key = GetKey(File, ExportName);
+	Committed.Add(Key, PackageName);
+
+	// Appended right away, so a crash still leaves a record of what finished
+	FFileHelper::SaveStringToFile(Key + "|" + PackageName + LINE_TERMINATOR, *JournalPath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+}
+
+FString FImportJob::GetKey(const FString& File, const FString& ExportName) {
+	return FPaths::ConvertRelativePathToFull(File) + ":" + ExportName;
+}
@@ -0,0 +1,257 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Utilities/LocalFetchProcess.h"
+
+#include "HttpModule.h"
+#include "JsonGlobals.h"
+#include "Interfaces/IPluginManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Guid.h"
+#include "Misc/Paths.h"
+#include "Settings/JsonAsAssetSettings.h"
+
+FProcHandle FLocalFetchProcess::ProcessHandle;
+FTSTicker::FDelegateHandle FLocalFetchProcess::TickerHandle;
+FTSTicker::FDelegateHandle FLocalFetchProcess::PollHandle;
+int32 FLocalFetchProcess::NumRestarts = 0;
+double FLocalFetchProcess::LaunchTime = 0.0;
+
+bool FLocalFetchProcess::bReady = false;
+bool FLocalFetchProcess::bPollInFlight = false;
+uint32 FLocalFetchProcess::HealthGeneration = 0;
+
+FString FLocalFetchProcess::GetExecutablePath() {
+	FString PluginBinariesFolder;
+
+	const TSharedPtr<IPlugin> PluginInfo = IPluginManager::Get().FindPlugin("JsonAsAsset");
+	if (PluginInfo.IsValid()) {
+		const FString PluginBaseDir = PluginInfo->GetBaseDir();
+		PluginBinariesFolder = FPaths::Combine(PluginBaseDir, TEXT("Binaries"));
+
+		if (!FPaths::DirectoryExists(PluginBinariesFolder)) {
+			PluginBinariesFolder = FPaths::Combine(PluginBaseDir, TEXT("JsonAsAsset/Binaries"));
+		}
+	}
+
+#if PLATFORM_WINDOWS
+	const FString ExecutableName = TEXT("JsonAsAssetAPI.exe");
+#else
+	const FString ExecutableName = TEXT("JsonAsAssetAPI");
+#endif
+
+	return FPaths::ConvertRelativePathToFull(FPaths::Combine(PluginBinariesFolder, FPlatformProcess::GetBinariesSubdirectory(), TEXT("JsonAsAsset_API"), ExecutableName));
+}
+
+void FLocalFetchProcess::Start() {
+	NumRestarts = 0;
+
+	// Warm instance, nothing to do
+	if (IsLaunched() || bReady)
+		return;
+
+	CheckHealth(1.0f, [](const bool bHealthy) {
+		if (!bHealthy && !IsLaunched())
+			Launch();
+	});
+}
+
+void FLocalFetchProcess::Stop() {
+	// Not restarted by the ticker once it goes away
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	TickerHandle.Reset();
+
+	// Whatever is still in flight was about the instance going away
+	HealthGeneration++;
+	bReady = false;
+	bPollInFlight = false;
+
+	if (ProcessHandle.IsValid()) {
+		FPlatformProcess::TerminateProc(ProcessHandle, true);
+		FPlatformProcess::CloseProc(ProcessHandle);
+		ProcessHandle.Reset();
+
+		return;
+	}
+
+	// Launched somewhere else (a previous editor session), ask it to stop itself
+	FString ShutdownToken;
+	if (!FFileHelper::LoadFileToString(ShutdownToken, *GetShutdownTokenPath()) || ShutdownToken.IsEmpty()) {
+		UE_LOG(LogJson, Warning, TEXT("Local Fetch API wasn't launched by the editor, close it from its console instead"));
+		return;
+	}
+
+	const UJsonAsAssetSettings* Settings = GetDefault<UJsonAsAssetSettings>();
+
+	const TSharedRef<IHttpRequest, ESPMode::ThreadSafe> HttpRequest = FHttpModule::Get().CreateRequest();
+	HttpRequest->SetURL(Settings->Url + "/api/v1/shutdown");
+	HttpRequest->SetVerb(TEXT("POST"));
+	HttpRequest->SetHeader("X-Shutdown-Token", ShutdownToken);
+	HttpRequest->SetTimeout(1.0f);
+
+	HttpRequest->OnProcessRequestComplete().BindLambda([](FHttpRequestPtr, const FHttpResponsePtr Response, bool) {
+		if (!Response.IsValid() || !EHttpResponseCodes::IsOk(Response->GetResponseCode()))
+			UE_LOG(LogJson, Warning, TEXT("Local Fetch API refused to shut down, close it from its console instead"));
+	});
+
+	HttpRequest->ProcessRequest();
+}
+
+void FLocalFetchProcess::CheckHealth(const float Timeout, TFunction<void(bool bHealthy)>&& OnChecked) {
+	const UJsonAsAssetSettings* Settings = GetDefault<UJsonAsAssetSettings>();
+
+	const TSharedRef<IHttpRequest, ESPMode::ThreadSafe> HttpRequest = FHttpModule::Get().CreateRequest();
+	HttpRequest->SetURL(Settings->Url + "/health");
+	HttpRequest->SetVerb(TEXT("GET"));
+	HttpRequest->SetTimeout(Timeout);
+
+	const TSharedRef<TFunction<void(bool)>> Callback = MakeShared<TFunction<void(bool)>>(MoveTemp(OnChecked));
+
+	// Completion is dispatched on the game thread
+	HttpRequest->OnProcessRequestComplete().BindLambda([Generation = HealthGeneration, Callback](FHttpRequestPtr, const FHttpResponsePtr Response, const bool bSucceeded) {
+		if (Generation != HealthGeneration)
+			return;
+
+		bReady = bSucceeded && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode());
+
+		(*Callback)(bReady);
+	});
+
+	// Never completes, answered right away (the poll would wait on it forever otherwise)
+	if (!HttpRequest->ProcessRequest()) {
+		bReady = false;
+
+		HttpRequest->OnProcessRequestComplete().Unbind();
+		(*Callback)(false);
+	}
+}
+
+bool FLocalFetchProcess::IsReady() {
+	return bReady;
+}
+
+void FLocalFetchProcess::StartPolling() {
+	if (PollHandle.IsValid())
+		return;
+
+	// First result as early as possible, then at the poll rate
+	Poll(0.0f);
+	PollHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&FLocalFetchProcess::Poll), PollInterval);
+}
+
+bool FLocalFetchProcess::IsLaunched() {
+	return ProcessHandle.IsValid() && FPlatformProcess::IsProcRunning(ProcessHandle);
+}
+
+void FLocalFetchProcess::Shutdown() {
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	FTSTicker::GetCoreTicker().RemoveTicker(PollHandle);
+	TickerHandle.Reset();
+	PollHandle.Reset();
+
+	if (ProcessHandle.IsValid()) {
+		FPlatformProcess::CloseProc(ProcessHandle);
+		ProcessHandle.Reset();
+	}
+}
+
+bool FLocalFetchProcess::Launch() {
+	const FString ExecutablePath = GetExecutablePath();
+
+	if (!FPaths::FileExists(ExecutablePath)) {
+		UE_LOG(LogJson, Error, TEXT("Local Fetch API not found at %s"), *ExecutablePath);
+		return false;
+	}
+
+	const UJsonAsAssetSettings* Settings = GetDefault<UJsonAsAssetSettings>();
+
+	// New token for every launch, whoever can't read it can't shut the instance down
+	const FString ShutdownToken = FGuid::NewGuid().ToString(EGuidFormats::Digits);
+	FFileHelper::SaveStringToFile(ShutdownToken, *GetShutdownTokenPath());
+
+	const FString Params = "--urls=" + Settings->Url + "/ --shutdown-token=" + ShutdownToken;
+
+	// The API finds the project config relative to its own binary, it's started from there
+	ProcessHandle = FPlatformProcess::CreateProc(*ExecutablePath, *Params, true, false, false, nullptr, 0, *FPaths::GetPath(ExecutablePath), nullptr);
+
+	if (!ProcessHandle.IsValid()) {
+		UE_LOG(LogJson, Error, TEXT("Failed to launch the Local Fetch API (%s)"), *ExecutablePath);
+		return false;
+	}
+
+	LaunchTime = FPlatformTime::Seconds();
+
+	if (!TickerHandle.IsValid())
+		TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&FLocalFetchProcess::Tick), TickInterval);
+
+	return true;
+}
+
+bool FLocalFetchProcess::Tick(float DeltaTime) {
+	if (!ProcessHandle.IsValid())
+		return true;
+
+	if (FPlatformProcess::IsProcRunning(ProcessHandle)) {
+		// Only crashes in a row give up on it, not a few spread over the session
+		if (NumRestarts > 0 && FPlatformTime::Seconds() - LaunchTime >= StableRunTime)
+			NumRestarts = 0;
+
+		return true;
+	}
+
+	int32 ReturnCode = 0;
+	FPlatformProcess::GetProcReturnCode(ProcessHandle, &ReturnCode);
+	FPlatformProcess::CloseProc(ProcessHandle);
+	ProcessHandle.Reset();
+
+	// Closed normally (or by the user), don't bring it back
+	if (ReturnCode == 0) {
+		TickerHandle.Reset();
+		return false;
+	}
+
+	if (NumRestarts >= MaxRestarts) {
+		UE_LOG(LogJson, Error, TEXT("Local Fetch API keeps exiting (code %d), not restarting it again"), ReturnCode);
+
+		TickerHandle.Reset();
+		return false;
+	}
+
+	NumRestarts++;
+	UE_LOG(LogJson, Warning, TEXT("Local Fetch API exited with code %d, restarting it (%d/%d)"), ReturnCode, NumRestarts, MaxRestarts);
+
+	if (!Launch()) {
+		TickerHandle.Reset();
+		return false;
+	}
+
+	return true;
+}
+
+bool FLocalFetchProcess::Poll(float DeltaTime) {
+	const UJsonAsAssetSettings* Settings = GetDefault<UJsonAsAssetSettings>();
+	// Disabled, the cached state (and any poll in flight) is dropped until it's enabled again
+	if (!Settings->bEnableLocalFetch) {
+		if (bReady || bPollInFlight) {
+			HealthGeneration++;
+			bReady = false;
+			bPollInFlight = false;
+		}
+
+		return true;
+	}
+
+	if (bPollInFlight)
+		return true;
+
+	bPollInFlight = true;
+
+	CheckHealth(PollInterval * 0.5f, [](bool) {
+		bPollInFlight = false;
+	});
+
+	return true;
+}
+
+FString FLocalFetchProcess::GetShutdownTokenPath() {
+	return FPaths::ProjectSavedDir() / TEXT("JsonAsAsset") / TEXT("LocalFetch.token");
+}
@@ -2,6 +2,7 @@
 
 #include "Utilities/MathUtilities.h"
 #include "Dom/JsonObject.h"
+#include "Utilities/EnumUtilities.h"
 
 FVector FMathUtilities::ObjectToVector(const FJsonObject* Object) {
 	return FVector(Object->GetNumberField("X"), Object->GetNumberField("Y"), Object->GetNumberField("Z"));
@@ -47,5 +48,5 @@ FFloatInterval FMathUtilities::ObjectToFloatInterval(const FJsonObject* Object)
 
 FRichCurveKey FMathUtilities::ObjectToRichCurveKey(const TSharedPtr<FJsonObject>& Object) {
 	FString InterpMode = Object->GetStringField("InterpMode");
-	return FRichCurveKey(Object->GetNumberField("Time"), Object->GetNumberField("Value"), Object->GetNumberField("ArriveTangent"), Object->GetNumberField("LeaveTangent"), static_cast<ERichCurveInterpMode>(StaticEnum<ERichCurveInterpMode>()->GetValueByNameString(InterpMode)));
+	return FRichCurveKey(Object->GetNumberField("Time"), Object->GetNumberField("Value"), Object->GetNumberField("ArriveTangent"), Object->GetNumberField("LeaveTangent"), FEnumUtilities::GetValue<ERichCurveInterpMode>(InterpMode));
 }
@@ -1,6 +1,7 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "Utilities/ObjectUtilities.h"
+#include "Utilities/ClassUtilities.h"
 #include "Utilities/PropertyUtilities.h"
 #include "Importers/Importer.h"
 #include "UObject/Package.h"
@@ -68,9 +69,41 @@ void UObjectSerializer::SetPropertySerializer(UPropertySerializer* NewPropertySe
 void UObjectSerializer::InitializeForDeserialization(const TArray<TSharedPtr<FJsonValue>>& ObjectsArray) {
 	this->LastObjectIndex = ObjectsArray.Num();
 
+	SerializedObjects.SetNum(LastObjectIndex);
 	for (int32 i = 0; i < LastObjectIndex; i++) {
-		SerializedObjects.Add(i, ObjectsArray[i]->AsObject());
+		SerializedObjects[i] = ObjectsArray[i]->AsObject();
 	}
+
+	LoadedObjects.SetNumZeroed(LastObjectIndex);
+	bObjectsLoaded.Init(false, LastObjectIndex);
+}
+
+const TSharedPtr<FJsonObject>& UObjectSerializer::FindSerializedObject(const int32 ObjectIndex) const {
+	static const TSharedPtr<FJsonObject> NullObject;
+	return SerializedObjects.IsValidIndex(ObjectIndex) ? SerializedObjects[ObjectIndex] : NullObject;
+}
+
+const TSharedPtr<FJsonObject>& UObjectSerializer::GetSerializedObject(const int32 ObjectIndex) const {
+	const TSharedPtr<FJsonObject>& ObjectJson = FindSerializedObject(ObjectIndex);
+	checkf(ObjectJson.IsValid(), TEXT("Object index %d is not serialized"), ObjectIndex);
+
+	return ObjectJson;
+}
+
+UObject* const* UObjectSerializer::FindLoadedObject(const int32 ObjectIndex) const {
+	return ObjectIndex >= 0 && ObjectIndex < bObjectsLoaded.Num() && bObjectsLoaded[ObjectIndex] ? &LoadedObjects[ObjectIndex] : nullptr;
+}
+
+void UObjectSerializer::SetLoadedObject(const int32 ObjectIndex, UObject* Object) {
+	check(ObjectIndex >= 0);
+
+	if (ObjectIndex >= LoadedObjects.Num()) {
+		LoadedObjects.SetNumZeroed(ObjectIndex + 1);
+		bObjectsLoaded.SetNum(ObjectIndex + 1, false);
+	}
+
+	LoadedObjects[ObjectIndex] = Object;
+	bObjectsLoaded[ObjectIndex] = true;
 }
 
 void UObjectSerializer::InitializeForSerialization(UPackage* NewSourcePackage) {
@@ -84,28 +117,31 @@ void UObjectSerializer::SetPackageForDeserialization(UPackage* SelfPackage) {
 }
 
 void UObjectSerializer::SetObjectMark(UObject* Object, const FString& ObjectMark) {
-	UObject* const* OldMarkObjectValue = ObjectMarks.FindKey(ObjectMark);
+	UObject* const* OldMarkObjectValue = MarkedObjects.Find(ObjectMark);
+	UObject* OldMarkObject = OldMarkObjectValue != NULL ? *OldMarkObjectValue : NULL;
 
 	// If we have an old value for this mark and it's the same object, exit early
-	if (OldMarkObjectValue != NULL && *OldMarkObjectValue == Object) {
+	if (OldMarkObject == Object && OldMarkObjectValue != NULL) {
 		return;
 	}
 
+	// An object holds a single mark, drop the one it had before
+	if (const FString* PreviousMark = this->ObjectMarks.Find(Object)) {
+		this->MarkedObjects.Remove(*PreviousMark);
+	}
+
 	this->ObjectMarks.Add(Object, ObjectMark);
+	this->MarkedObjects.Add(ObjectMark, Object);
 
 	// If we have an old mapping, remove it immediately and try to remap old objects to new ones
 	if (OldMarkObjectValue != NULL) {
-		this->ObjectMarks.Remove(*OldMarkObjectValue);
+		this->ObjectMarks.Remove(OldMarkObject);
 
-		TArray<int32> IndicesToOverwrite;
-		for (const TPair<int32, UObject*>& Pair : this->LoadedObjects) {
-			if (Pair.Value == *OldMarkObjectValue) {
-				IndicesToOverwrite.Add(Pair.Key);
+		for (TConstSetBitIterator<> It(bObjectsLoaded); It; ++It) {
+			if (LoadedObjects[It.GetIndex()] == OldMarkObject) {
+				LoadedObjects[It.GetIndex()] = Object;
 			}
 		}
-		for (const int32 ObjectIndex : IndicesToOverwrite) {
-			this->LoadedObjects.Add(ObjectIndex, Object);
-		}
 	}
 }
 
@@ -123,7 +159,8 @@ int32 UObjectSerializer::SerializeObject(UObject* Object) {
 
 	TSharedRef<FJsonObject> ResultJson = MakeShareable(new FJsonObject());
 	ResultJson->SetNumberField(TEXT("ObjectIndex"), NewObjectIndex);
-	SerializedObjects.Add(NewObjectIndex, ResultJson);
+	SerializedObjects.SetNum(LastObjectIndex);
+	SerializedObjects[NewObjectIndex] = ResultJson;
 
 	if (ObjectPackage != SourcePackage) {
 		ResultJson->SetStringField(TEXT("Type"), TEXT("Import"));
@@ -149,22 +186,24 @@ UObject* UObjectSerializer::DeserializeObject(int32 Index) {
 
 	if (Index == 1)
 		Index = 0;
-	UObject** LoadedObject = LoadedObjects.Find(Index);
+	UObject* const* LoadedObject = FindLoadedObject(Index);
 	if (LoadedObject != nullptr)
 		return *LoadedObject;
 
-	if (!SerializedObjects.Contains(Index)) {
+	// Held by value, deserializing can grow the table
+	const TSharedPtr<FJsonObject> ObjectJson = FindSerializedObject(Index);
+
+	if (!ObjectJson.IsValid()) {
 		UE_LOG(LogObjectSerializer, Error, TEXT("DeserializeObject for package %s called with invalid Index: %d"), *SourcePackage->GetName(), Index);
 		return nullptr;
 	}
 
-	const TSharedPtr<FJsonObject>& ObjectJson = SerializedObjects.FindChecked(Index);
 	FString ObjectType = Index == 0 ? "Import" : "Export";
 
 	if (ObjectType == TEXT("Import")) {
 		// Object is imported from another package, and not located in our own
 		UObject* NewLoadedObject = DeserializeImportedObject(ObjectJson);
-		LoadedObjects.Add(Index, NewLoadedObject);
+		SetLoadedObject(Index, NewLoadedObject);
 
 		return NewLoadedObject;
 	}
@@ -176,7 +215,7 @@ UObject* UObjectSerializer::DeserializeObject(int32 Index) {
 		if (ObjectJson->HasField(TEXT("ObjectMark"))) {
 			// Object is serialized through object mark
 			const FString ObjectMark = ObjectJson->GetStringField(TEXT("ObjectMark"));
-			UObject* const* FoundObject = ObjectMarks.FindKey(ObjectMark);
+			UObject* const* FoundObject = MarkedObjects.Find(ObjectMark);
 			checkf(FoundObject, TEXT("Cannot resolve object serialized using mark: %s"), *ObjectMark);
 			ConstructedObject = *FoundObject;
 		} else {
@@ -184,7 +223,7 @@ UObject* UObjectSerializer::DeserializeObject(int32 Index) {
 			ConstructedObject = DeserializeExportedObject(Index, ObjectJson);
 		}
 
-		LoadedObjects.Add(Index, ConstructedObject);
+		SetLoadedObject(Index, ConstructedObject);
 		return ConstructedObject;
 	}
 
@@ -234,7 +273,7 @@ bool UObjectSerializer::CompareObjectsWithContext(const int32 ObjectIndex, UObje
 			return false;
 
 		// If the object is not found, deserializing it would still be NULL
-		const TSharedPtr<FJsonObject>& ObjectJson = SerializedObjects.FindChecked(ObjectIndex);
+		const TSharedPtr<FJsonObject> ObjectJson = GetSerializedObject(ObjectIndex);
 		const FString ObjectType = ObjectJson->GetStringField(TEXT("Type"));
 
 		return ObjectType == TEXT("Import") && DeserializeObject(ObjectIndex) == NULL;
@@ -245,7 +284,7 @@ bool UObjectSerializer::CompareObjectsWithContext(const int32 ObjectIndex, UObje
 	if (CompareContext->HasObjectAlreadyBeenCompared(ObjectIndex, Object))
 		return true;
 
-	const TSharedPtr<FJsonObject>& ObjectJson = SerializedObjects.FindChecked(ObjectIndex);
+	const TSharedPtr<FJsonObject> ObjectJson = GetSerializedObject(ObjectIndex);
 	const FString ObjectType = ObjectJson->GetStringField(TEXT("Type"));
 	const FObjectCompareSettings CompareSettings = CompareContext->GetObjectSettings(ObjectIndex);
 
@@ -270,7 +309,7 @@ bool UObjectSerializer::CompareObjectsWithContext(const int32 ObjectIndex, UObje
 	// Check if object is serialized through mark first
 	if (ObjectJson->HasField(TEXT("ObjectMark"))) {
 		const FString ObjectMark = ObjectJson->GetStringField(TEXT("ObjectMark"));
-		UObject* const* FoundObject = ObjectMarks.FindKey(ObjectMark);
+		UObject* const* FoundObject = MarkedObjects.Find(ObjectMark);
 
 		checkf(FoundObject, TEXT("Cannot resolve object serialized using mark: %s"), *ObjectMark);
 		UObject* RegisteredObject = *FoundObject;
@@ -337,11 +376,11 @@ void UObjectSerializer::FlushPropertiesIntoObject(const int32 ObjectIndex, UObje
 	check(ObjectIndex != INDEX_NONE);
 	check(Object);
 
-	const TSharedPtr<FJsonObject> ObjectData = this->SerializedObjects.FindChecked(ObjectIndex);
+	const TSharedPtr<FJsonObject> ObjectData = GetSerializedObject(ObjectIndex);
 	if (ObjectData->Values.Num() == 0) return; // If the object entry is empty, ignore
 
-	checkf(!this->LoadedObjects.Contains(ObjectIndex), TEXT("Cannot flush properties into already deserialized object"));
-	this->LoadedObjects.Add(ObjectIndex, Object);
+	checkf(FindLoadedObject(ObjectIndex) == nullptr, TEXT("Cannot flush properties into already deserialized object"));
+	SetLoadedObject(ObjectIndex, Object);
 
 	const FString ObjectType = ObjectData->GetStringField(TEXT("Type"));
 	checkf(ObjectType == TEXT("Export"), TEXT("Can only call FlushPropertiesIntoObject for exported objects"));
@@ -388,11 +427,11 @@ TArray<TSharedPtr<FJsonValue>> UObjectSerializer::FinalizeSerialization() {
 	TArray<TSharedPtr<FJsonValue>> ObjectsArray;
 
 	for (int32 i = 0; i < LastObjectIndex; i++) {
-		if (!SerializedObjects.Contains(i)) {
+		if (!FindSerializedObject(i).IsValid()) {
 			checkf(false, TEXT("Object not in serialized objects: %s"), *(*ObjectIndices.FindKey(i))->GetPathName());
 		}
 		
-		ObjectsArray.Add(MakeShareable(new FJsonValueObject(SerializedObjects.FindChecked(i))));
+		ObjectsArray.Add(MakeShareable(new FJsonValueObject(SerializedObjects[i])));
 	}
 	return ObjectsArray;
 }
@@ -415,7 +454,7 @@ void UObjectSerializer::CollectObjectPackages(const int32 ObjectIndex, TArray<FS
 		return;
 
 	ObjectsAlreadySerialized.Add(ObjectIndex);
-	const TSharedPtr<FJsonObject> Object = SerializedObjects.FindChecked(ObjectIndex);
+	const TSharedPtr<FJsonObject> Object = GetSerializedObject(ObjectIndex);
 	const FString ObjectType = Object->GetStringField(TEXT("Type"));
 
 	if (ObjectType == TEXT("Import")) {
@@ -452,7 +491,7 @@ void UObjectSerializer::CollectObjectPackages(const int32 ObjectIndex, TArray<FS
 }
 
 FString UObjectSerializer::GetObjectFullPath(int32 ObjectIndex) {
-	const TSharedPtr<FJsonObject> Object = SerializedObjects.FindChecked(ObjectIndex);
+	const TSharedPtr<FJsonObject> Object = GetSerializedObject(ObjectIndex);
 	const FString ObjectType = Object->GetStringField(TEXT("Type"));
 
 	if (ObjectType == TEXT("Import")) {
@@ -499,10 +538,7 @@ UObject* UObjectSerializer::DeserializeExportedObject(int32 ObjectIndex, TShared
 	// Object is defined inside our own package, so we should have
 	// NOTE: Probably shouldn't be a export
 	const FString ObjectClassIndex = ObjectJson->GetStringField(TEXT("Type"));
-	const FString PackageName = "/Script/Engine";
-
-	UPackage* ClassPackage = FindOrLoadPackage(PackageName);
-	UClass* ObjectClass = FindObjectFast<UClass>(ClassPackage, *ObjectClassIndex);
+	UClass* ObjectClass = FClassUtilities::FindClass(*ObjectClassIndex);
 
 	if (ObjectClass == nullptr) {
 		UE_LOG(LogObjectSerializer, Error, TEXT("DeserializeObject for package %s failed: Cannot resolve object class %s"), *SourcePackage->GetName(), *ObjectClassIndex);
@@ -545,7 +581,7 @@ UObject* UObjectSerializer::DeserializeExportedObject(int32 ObjectIndex, TShared
 	}
 
 	// Record constructed object so when properties reference it through outer chain we do not run into stack overflow
-	LoadedObjects.Add(ObjectIndex, ConstructedObject);
+	SetLoadedObject(ObjectIndex, ConstructedObject);
 
 	// Deserialize object properties now
 	if (ObjectJson->HasField(TEXT("Properties"))) {
@@ -560,20 +596,13 @@ UObject* UObjectSerializer::DeserializeExportedObject(int32 ObjectIndex, TShared
 
 UObject* UObjectSerializer::DeserializeImportedObject(TSharedPtr<FJsonObject> ObjectJson) {
 	const FString ObjectClassIndex = ObjectJson->GetStringField(TEXT("Type"));
-	const FString PackageName = "/Script/Engine";
-	UPackage* ClassPackage = FindOrLoadPackage(PackageName);
 	
 	const FString ClassName = ObjectJson->GetStringField(TEXT("ClassName"));
 	const FString ObjectName = ObjectJson->GetStringField(TEXT("Name"));
 	
-	if (ClassPackage == NULL) {
-		UE_LOG(LogObjectSerializer, Error, TEXT("Failed to resolve class package %s"), *PackageName);
-		return NULL;
-	}
-	
-	UClass* ObjectClass = FindObjectFast<UClass>(ClassPackage, *ObjectClassIndex);
+	UClass* ObjectClass = FClassUtilities::FindClass(*ObjectClassIndex);
 	if (ObjectClass == NULL) {
-		UE_LOG(LogObjectSerializer, Error, TEXT("Failed to resolve class %s inside of the package %s (requested by %s)"), *ClassName, *PackageName, *SourcePackage->GetName());
+		UE_LOG(LogObjectSerializer, Error, TEXT("Failed to resolve class %s (requested by %s)"), *ClassName, *SourcePackage->GetName());
 		return NULL;
 	}
 
@@ -0,0 +1,122 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Utilities/PrefetchUtilities.h"
+
+#include "Async/Async.h"
+#include "HttpModule.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Utilities/AssetUtilities.h"
+#include "Utilities/RemoteUtilities.h"
+
+FCriticalSection FPrefetchUtilities::Lock;
+TMap<FString, TSharedFuture<TSharedPtr<FJsonObject>>> FPrefetchUtilities::Files;
+TMap<FString, TSharedRef<IHttpRequest, ESPMode::ThreadSafe>> FPrefetchUtilities::Requests;
+
+FPrefetchUtilities::FBatchScope::~FBatchScope() {
+	if (--BatchDepth != 0)
+		return;
+
+	FAssetUtilities::WaitForTextureImports();
+	Reset();
+}
+
+void FPrefetchUtilities::PrefetchFile(const FString& File) {
+	FScopeLock ScopeLock(&Lock);
+	if (Files.Contains(File))
+		return;
+
+	Files.Add(File, Async(EAsyncExecution::ThreadPool, [File]() {
+		return LoadReferenceFile(File);
+	}).Share());
+}
+
+bool FPrefetchUtilities::TakeFile(const FString& File, TSharedPtr<FJsonObject>& OutJsonParsed) {
+	TSharedFuture<TSharedPtr<FJsonObject>> Future; {
+		FScopeLock ScopeLock(&Lock);
+		if (!Files.RemoveAndCopyValue(File, Future))
+			return false;
+	}
+
+	OutJsonParsed = Future.Get();
+
+	return true;
+}
+
+void FPrefetchUtilities::PrefetchRequest(const FString& URL, const FString& ContentType) {
+	FScopeLock ScopeLock(&Lock);
+	if (Requests.Contains(URL) || Requests.Num() >= MaxRequestsInFlight)
+		return;
+
+	const TSharedRef<IHttpRequest, ESPMode::ThreadSafe> HttpRequest = FHttpModule::Get().CreateRequest();
+	HttpRequest->SetURL(URL);
+	HttpRequest->SetVerb(TEXT("GET"));
+
+	if (!ContentType.IsEmpty())
+		HttpRequest->SetHeader("content-type", ContentType);
+
+	if (HttpRequest->ProcessRequest())
+		Requests.Add(URL, HttpRequest);
+}
+
+bool FPrefetchUtilities::HasRequest(const FString& URL) {
+	FScopeLock ScopeLock(&Lock);
+
+	return Requests.Contains(URL);
+}
+
+TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> FPrefetchUtilities::TakeRequest(const FString& URL) {
+	FScopeLock ScopeLock(&Lock);
+
+	TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> HttpRequest;
+	if (const TSharedRef<IHttpRequest, ESPMode::ThreadSafe>* Found = Requests.Find(URL)) {
+		HttpRequest = *Found;
+		Requests.Remove(URL);
+	}
+
+	return HttpRequest;
+}
+
+TSharedPtr<IHttpResponse, ESPMode::ThreadSafe> FPrefetchUtilities::TakeResponse(const FString& URL) {
+	const TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> HttpRequest = TakeRequest(URL);
+	if (!HttpRequest.IsValid())
+		return nullptr;
+
+	return FRemoteUtilities::WaitForRequest(HttpRequest.ToSharedRef());
+}
+
+void FPrefetchUtilities::Reset() {
+	TArray<TSharedRef<IHttpRequest, ESPMode::ThreadSafe>> PendingRequests; {
+		FScopeLock ScopeLock(&Lock);
+
+		// Workers capture nothing but the path, files still being read are just abandoned
+		Files.Empty();
+
+		Requests.GenerateValueArray(PendingRequests);
+		Requests.Empty();
+	}
+
+	for (const TSharedRef<IHttpRequest, ESPMode::ThreadSafe>& HttpRequest : PendingRequests)
+		HttpRequest->CancelRequest();
+}
+
+TSharedPtr<FJsonObject> FPrefetchUtilities::LoadReferenceFile(const FString& File) {
+	/* ----  Parse JSON into UE JSON Reader ---- */
+	FString ContentBefore;
+	if (!FFileHelper::LoadFileToString(ContentBefore, *File))
+		return nullptr;
+
+	FString Content = FString(TEXT("{\"data\": "));
+	Content.Append(ContentBefore);
+	Content.Append(FString("}"));
+
+	TSharedPtr<FJsonObject> JsonParsed;
+	const TSharedRef<TJsonReader<TCHAR>> JsonReader = TJsonReaderFactory<TCHAR>::Create(Content);
+	/* ---------------------------------------- */
+
+	if (!FJsonSerializer::Deserialize(JsonReader, JsonParsed))
+		return nullptr;
+
+	return JsonParsed;
+}
@@ -1,13 +1,107 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "Utilities/PropertyUtilities.h"
+#include "JsonGlobals.h"
+#include "Utilities/EnumUtilities.h"
 #include "Utilities/ObjectUtilities.h"
 #include "UObject/TextProperty.h"
+#include "Curves/RichCurve.h"
 #include "Importers/Importer.h"
 
 DECLARE_LOG_CATEGORY_CLASS(LogPropertySerializer, Error, Log);
 PRAGMA_DISABLE_OPTIMIZATION
 
+template <typename T> static constexpr FNativeStructField::EType GetNativeFieldType();
+template <> constexpr FNativeStructField::EType GetNativeFieldType<float>() { return FNativeStructField::EType::Float; }
+template <> constexpr FNativeStructField::EType GetNativeFieldType<double>() { return FNativeStructField::EType::Double; }
+template <> constexpr FNativeStructField::EType GetNativeFieldType<uint8>() { return FNativeStructField::EType::Byte; }
+template <> constexpr FNativeStructField::EType GetNativeFieldType<uint32>() { return FNativeStructField::EType::UInt32; }
+
+#define NATIVE_FIELD(Struct, Member) { TEXT(#Member), STRUCT_OFFSET(Struct, Member), GetNativeFieldType<decltype(Struct::Member)>() }
+#define NATIVE_ENUM_FIELD(Struct, Member, Enum) { TEXT(#Member), STRUCT_OFFSET(Struct, Member), FNativeStructField::EType::Byte, StaticEnum<Enum>() }
+
+// Set while a worker runs DeserializeStructDeferred, object references go there instead of being loaded
+static thread_local TArray<FPropertyFixup>* DeferredFixups = nullptr;
+
+// References that need the game thread (loading, or the object serializer's tables). Texts too, LOCTABLE
+// entries find or load their string table, and field paths look up their owner
+static bool IsDeferredProperty(const FProperty* Property) {
+	return Property->IsA<FInterfaceProperty>() || (Property->IsA<FObjectPropertyBase>() && !Property->IsA<FSoftObjectProperty>()) ||
+		Property->IsA<FTextProperty>() || Property->IsA<FFieldPathProperty>();
+}
+
+static bool HoldsDeferredReferences(const FProperty* Property, TSet<const UStruct*>& VisitedStructs);
+
+static bool StructHoldsDeferredReferences(const UStruct* Struct, TSet<const UStruct*>& VisitedStructs) {
+	bool bAlreadyVisited;
+	VisitedStructs.Add(Struct, &bAlreadyVisited);
+
+	if (bAlreadyVisited)
+		return false;
+
+	for (const FProperty* Property = Struct->PropertyLink; Property; Property = Property->PropertyLinkNext) {
+		if (HoldsDeferredReferences(Property, VisitedStructs))
+			return true;
+	}
+
+	return false;
+}
+
+static bool HoldsDeferredReferences(const FProperty* Property, TSet<const UStruct*>& VisitedStructs) {
+	if (IsDeferredProperty(Property))
+		return true;
+
+	if (const FArrayProperty* ArrayProperty = CastField<const FArrayProperty>(Property))
+		return HoldsDeferredReferences(ArrayProperty->Inner, VisitedStructs);
+	if (const FSetProperty* SetProperty = CastField<const FSetProperty>(Property))
+		return HoldsDeferredReferences(SetProperty->ElementProp, VisitedStructs);
+	if (const FMapProperty* MapProperty = CastField<const FMapProperty>(Property))
+		return HoldsDeferredReferences(MapProperty->KeyProp, VisitedStructs) || HoldsDeferredReferences(MapProperty->ValueProp, VisitedStructs);
+	if (const FStructProperty* StructProperty = CastField<const FStructProperty>(Property))
+		return StructHoldsDeferredReferences(StructProperty->Struct, VisitedStructs);
+
+	return false;
+}
+
+static bool CanDeferReferences(const FProperty* Property, TSet<const UStruct*>& VisitedStructs);
+
+static bool CanDeferStructReferences(const UStruct* Struct, TSet<const UStruct*>& VisitedStructs) {
+	bool bAlreadyVisited;
+	VisitedStructs.Add(Struct, &bAlreadyVisited);
+
+	if (bAlreadyVisited)
+		return true;
+
+	for (const FProperty* Property = Struct->PropertyLink; Property; Property = Property->PropertyLinkNext) {
+		if (!CanDeferReferences(Property, VisitedStructs))
+			return false;
+	}
+
+	return true;
+}
+
+// Set elements are built aside and copied, and map entries move while the map grows,
+// so a fixup pointing into them would be left dangling
+static bool CanDeferReferences(const FProperty* Property, TSet<const UStruct*>& VisitedStructs) {
+	if (const FArrayProperty* ArrayProperty = CastField<const FArrayProperty>(Property))
+		return CanDeferReferences(ArrayProperty->Inner, VisitedStructs);
+
+	if (const FSetProperty* SetProperty = CastField<const FSetProperty>(Property)) {
+		TSet<const UStruct*> ElementStructs;
+		return !HoldsDeferredReferences(SetProperty->ElementProp, ElementStructs);
+	}
+
+	if (const FMapProperty* MapProperty = CastField<const FMapProperty>(Property)) {
+		TSet<const UStruct*> EntryStructs;
+		return !HoldsDeferredReferences(MapProperty->KeyProp, EntryStructs) && !HoldsDeferredReferences(MapProperty->ValueProp, EntryStructs);
+	}
+
+	if (const FStructProperty* StructProperty = CastField<const FStructProperty>(Property))
+		return CanDeferStructReferences(StructProperty->Struct, VisitedStructs);
+
+	return true;
+}
+
 void FDateTimeSerializer::Serialize(UScriptStruct* Struct, const TSharedPtr<FJsonObject> JsonValue, const void* StructData, TArray<int32>* OutReferencedSubobjects) {
 	const FDateTime* DateTime = (const FDateTime*)StructData;
 	JsonValue->SetStringField(TEXT("Ticks"), FString::Printf(TEXT("%llu"), DateTime->GetTicks()));
@@ -42,6 +136,181 @@ bool FTimespanSerializer::Compare(UScriptStruct* Struct, const TSharedPtr<FJsonO
 	return Timespan->GetTicks() == Ticks;
 }
 
+// Decodes a json value into a member, false if it isn't a number (or a name of the field's enum)
+static bool DecodeNativeField(const FNativeStructField& Field, const FJsonValue& JsonValue, uint8* Member) {
+	if (Field.Enum != nullptr && JsonValue.Type == EJson::String) {
+		// Left as it is, INDEX_NONE would be written as 255
+		const int64 Value = FEnumUtilities::GetValue(Field.Enum, JsonValue.AsString());
+		if (Value == INDEX_NONE) {
+			UE_LOG(LogJson, Warning, TEXT("\"%s\" isn't a value of %s, field %s left unchanged"), *JsonValue.AsString(), *Field.Enum->GetName(), Field.Name);
+			return false;
+		}
+
+		*Member = static_cast<uint8>(Value);
+		return true;
+	}
+
+	double Number;
+	if (!JsonValue.TryGetNumber(Number))
+		return false;
+
+	switch (Field.Type) {
+	case FNativeStructField::EType::Float: *reinterpret_cast<float*>(Member) = static_cast<float>(Number); break;
+	case FNativeStructField::EType::Double: *reinterpret_cast<double*>(Member) = Number; break;
+	case FNativeStructField::EType::Byte: *Member = static_cast<uint8>(Number); break;
+	case FNativeStructField::EType::UInt32: *reinterpret_cast<uint32*>(Member) = static_cast<uint32>(Number); break;
+	}
+
+	return true;
+}
+
+static bool IdenticalNativeField(const FNativeStructField& Field, const uint8* A, const uint8* B) {
+	switch (Field.Type) {
+	case FNativeStructField::EType::Float: return *reinterpret_cast<const float*>(A) == *reinterpret_cast<const float*>(B);
+	case FNativeStructField::EType::Double: return *reinterpret_cast<const double*>(A) == *reinterpret_cast<const double*>(B);
+	case FNativeStructField::EType::Byte: return *A == *B;
+	case FNativeStructField::EType::UInt32: return *reinterpret_cast<const uint32*>(A) == *reinterpret_cast<const uint32*>(B);
+	default: return false;
+	}
+}
+
+FNativeStructSerializer::FNativeStructSerializer(const TArray<FNativeStructField>& InFields) : Fields(InFields) {
+}
+
+const FNativeStructField* FNativeStructSerializer::FindField(const FString& Name) const {
+	for (const FNativeStructField& Field : Fields) {
+		if (FCString::Stricmp(*Name, Field.Name) == 0)
+			return &Field;
+	}
+
+	return nullptr;
+}
+
+void FNativeStructSerializer::SerializeFields(FJsonObject& JsonValue, const void* StructData) const {
+	for (const FNativeStructField& Field : Fields) {
+		const uint8* Member = static_cast<const uint8*>(StructData) + Field.Offset;
+
+		switch (Field.Type) {
+		case FNativeStructField::EType::Float: JsonValue.SetNumberField(Field.Name, *reinterpret_cast<const float*>(Member)); break;
+		case FNativeStructField::EType::Double: JsonValue.SetNumberField(Field.Name, *reinterpret_cast<const double*>(Member)); break;
+		case FNativeStructField::EType::UInt32: JsonValue.SetNumberField(Field.Name, *reinterpret_cast<const uint32*>(Member)); break;
+		case FNativeStructField::EType::Byte:
+			if (Field.Enum != nullptr) JsonValue.SetStringField(Field.Name, Field.Enum->GetNameByValue(*Member).ToString());
+			else JsonValue.SetNumberField(Field.Name, *Member);
+			break;
+		}
+	}
+}
+
+void FNativeStructSerializer::DeserializeFields(void* StructData, const FJsonObject& JsonValue) const {
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& Pair : JsonValue.Values) {
+		const FNativeStructField* Field = FindField(Pair.Key);
+
+		if (Field != nullptr && Pair.Value.IsValid())
+			DecodeNativeField(*Field, *Pair.Value, static_cast<uint8*>(StructData) + Field->Offset);
+	}
+}
+
+bool FNativeStructSerializer::CompareFields(const FJsonObject& JsonValue, const void* StructData) const {
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& Pair : JsonValue.Values) {
+		const FNativeStructField* Field = FindField(Pair.Key);
+		if (Field == nullptr || !Pair.Value.IsValid())
+			continue;
+
+		// Read back as the field's type, so aligned for the widest of them
+		alignas(double) uint8 Decoded[sizeof(double)];
+		if (DecodeNativeField(*Field, *Pair.Value, Decoded) && !IdenticalNativeField(*Field, Decoded, static_cast<const uint8*>(StructData) + Field->Offset))
+			return false;
+	}
+
+	return true;
+}
+
+void FNativeStructSerializer::Serialize(UScriptStruct* Struct, const TSharedPtr<FJsonObject> JsonValue, const void* StructData, TArray<int32>* OutReferencedSubobjects) {
+	SerializeFields(*JsonValue, StructData);
+}
+
+void FNativeStructSerializer::Deserialize(UScriptStruct* Struct, void* StructData, const TSharedPtr<FJsonObject> JsonValue) {
+	DeserializeFields(StructData, *JsonValue);
+}
+
+bool FNativeStructSerializer::Compare(UScriptStruct* Struct, const TSharedPtr<FJsonObject> JsonValue, const void* StructData, const TSharedPtr<FObjectCompareContext> Context) {
+	return CompareFields(*JsonValue, StructData);
+}
+
+FTransformSerializer::FTransformSerializer(const FNativeStructSerializer& InQuatSerializer, const FNativeStructSerializer& InVectorSerializer) : QuatSerializer(InQuatSerializer), VectorSerializer(InVectorSerializer) {
+}
+
+void FTransformSerializer::Serialize(UScriptStruct* Struct, const TSharedPtr<FJsonObject> JsonValue, const void* StructData, TArray<int32>* OutReferencedSubobjects) {
+	const FTransform* Transform = static_cast<const FTransform*>(StructData);
+
+	const FQuat Rotation = Transform->GetRotation();
+	const FVector Translation = Transform->GetTranslation();
+	const FVector Scale3D = Transform->GetScale3D();
+
+	const TSharedRef<FJsonObject> RotationJson = MakeShared<FJsonObject>();
+	const TSharedRef<FJsonObject> TranslationJson = MakeShared<FJsonObject>();
+	const TSharedRef<FJsonObject> Scale3DJson = MakeShared<FJsonObject>();
+
+	QuatSerializer.SerializeFields(*RotationJson, &Rotation);
+	VectorSerializer.SerializeFields(*TranslationJson, &Translation);
+	VectorSerializer.SerializeFields(*Scale3DJson, &Scale3D);
+
+	JsonValue->SetObjectField(TEXT("Rotation"), RotationJson);
+	JsonValue->SetObjectField(TEXT("Translation"), TranslationJson);
+	JsonValue->SetObjectField(TEXT("Scale3D"), Scale3DJson);
+}
+
+void FTransformSerializer::Deserialize(UScriptStruct* Struct, void* StructData, const TSharedPtr<FJsonObject> JsonValue) {
+	FTransform* Transform = static_cast<FTransform*>(StructData);
+
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& Pair : JsonValue->Values) {
+		if (!Pair.Value.IsValid() || Pair.Value->Type != EJson::Object)
+			continue;
+
+		const FJsonObject& FieldJson = *Pair.Value->AsObject();
+
+		if (FCString::Stricmp(*Pair.Key, TEXT("Rotation")) == 0) {
+			FQuat Rotation = Transform->GetRotation();
+			QuatSerializer.DeserializeFields(&Rotation, FieldJson);
+			Transform->SetRotation(Rotation);
+		} else if (FCString::Stricmp(*Pair.Key, TEXT("Translation")) == 0) {
+			FVector Translation = Transform->GetTranslation();
+			VectorSerializer.DeserializeFields(&Translation, FieldJson);
+			Transform->SetTranslation(Translation);
+		} else if (FCString::Stricmp(*Pair.Key, TEXT("Scale3D")) == 0) {
+			FVector Scale3D = Transform->GetScale3D();
+			VectorSerializer.DeserializeFields(&Scale3D, FieldJson);
+			Transform->SetScale3D(Scale3D);
+		}
+	}
+}
+
+bool FTransformSerializer::Compare(UScriptStruct* Struct, const TSharedPtr<FJsonObject> JsonValue, const void* StructData, const TSharedPtr<FObjectCompareContext> Context) {
+	const FTransform* Transform = static_cast<const FTransform*>(StructData);
+
+	const FQuat Rotation = Transform->GetRotation();
+	const FVector Translation = Transform->GetTranslation();
+	const FVector Scale3D = Transform->GetScale3D();
+
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& Pair : JsonValue->Values) {
+		if (!Pair.Value.IsValid() || Pair.Value->Type != EJson::Object)
+			continue;
+
+		const FJsonObject& FieldJson = *Pair.Value->AsObject();
+
+		if (FCString::Stricmp(*Pair.Key, TEXT("Rotation")) == 0) {
+			if (!QuatSerializer.CompareFields(FieldJson, &Rotation)) return false;
+		} else if (FCString::Stricmp(*Pair.Key, TEXT("Translation")) == 0) {
+			if (!VectorSerializer.CompareFields(FieldJson, &Translation)) return false;
+		} else if (FCString::Stricmp(*Pair.Key, TEXT("Scale3D")) == 0) {
+			if (!VectorSerializer.CompareFields(FieldJson, &Scale3D)) return false;
+		}
+	}
+
+	return true;
+}
+
 FFallbackStructSerializer::FFallbackStructSerializer(UPropertySerializer* Serializer) : PropertySerializer(Serializer) {
 }
 
@@ -99,6 +368,38 @@ UPropertySerializer::UPropertySerializer() {
 
 	this->StructSerializers.Add(DateTimeStruct, MakeShared<FDateTimeSerializer>());
 	this->StructSerializers.Add(TimespanStruct, MakeShared<FTimespanSerializer>());
+
+	// Structs found in almost every export, decoded without going through reflection (fields in reflection order)
+	const FNativeStructSerializer QuatSerializer({ NATIVE_FIELD(FQuat, X), NATIVE_FIELD(FQuat, Y), NATIVE_FIELD(FQuat, Z), NATIVE_FIELD(FQuat, W) });
+	const FNativeStructSerializer VectorSerializer({ NATIVE_FIELD(FVector, X), NATIVE_FIELD(FVector, Y), NATIVE_FIELD(FVector, Z) });
+
+	this->StructSerializers.Add(TBaseStructure<FQuat>::Get(), MakeShared<FNativeStructSerializer>(QuatSerializer));
+	this->StructSerializers.Add(TBaseStructure<FVector>::Get(), MakeShared<FNativeStructSerializer>(VectorSerializer));
+	this->StructSerializers.Add(TBaseStructure<FTransform>::Get(), MakeShared<FTransformSerializer>(QuatSerializer, VectorSerializer));
+
+	this->StructSerializers.Add(TBaseStructure<FGuid>::Get(), MakeShared<FNativeStructSerializer>(TArray<FNativeStructField>{
+		NATIVE_FIELD(FGuid, A), NATIVE_FIELD(FGuid, B), NATIVE_FIELD(FGuid, C), NATIVE_FIELD(FGuid, D)
+	}));
+	this->StructSerializers.Add(TBaseStructure<FVector2D>::Get(), MakeShared<FNativeStructSerializer>(TArray<FNativeStructField>{
+		NATIVE_FIELD(FVector2D, X), NATIVE_FIELD(FVector2D, Y)
+	}));
+	this->StructSerializers.Add(TBaseStructure<FRotator>::Get(), MakeShared<FNativeStructSerializer>(TArray<FNativeStructField>{
+		NATIVE_FIELD(FRotator, Pitch), NATIVE_FIELD(FRotator, Yaw), NATIVE_FIELD(FRotator, Roll)
+	}));
+	this->StructSerializers.Add(TBaseStructure<FLinearColor>::Get(), MakeShared<FNativeStructSerializer>(TArray<FNativeStructField>{
+		NATIVE_FIELD(FLinearColor, R), NATIVE_FIELD(FLinearColor, G), NATIVE_FIELD(FLinearColor, B), NATIVE_FIELD(FLinearColor, A)
+	}));
+	this->StructSerializers.Add(TBaseStructure<FColor>::Get(), MakeShared<FNativeStructSerializer>(TArray<FNativeStructField>{
+		NATIVE_FIELD(FColor, B), NATIVE_FIELD(FColor, G), NATIVE_FIELD(FColor, R), NATIVE_FIELD(FColor, A)
+	}));
+	this->StructSerializers.Add(FRichCurveKey::StaticStruct(), MakeShared<FNativeStructSerializer>(TArray<FNativeStructField>{
+		NATIVE_ENUM_FIELD(FRichCurveKey, InterpMode, ERichCurveInterpMode),
+		NATIVE_ENUM_FIELD(FRichCurveKey, TangentMode, ERichCurveTangentMode),
+		NATIVE_ENUM_FIELD(FRichCurveKey, TangentWeightMode, ERichCurveTangentWeightMode),
+		NATIVE_FIELD(FRichCurveKey, Time), NATIVE_FIELD(FRichCurveKey, Value),
+		NATIVE_FIELD(FRichCurveKey, ArriveTangent), NATIVE_FIELD(FRichCurveKey, ArriveTangentWeight),
+		NATIVE_FIELD(FRichCurveKey, LeaveTangent), NATIVE_FIELD(FRichCurveKey, LeaveTangentWeight)
+	}));
 }
 
 void UPropertySerializer::DeserializePropertyValue(FProperty* Property, const TSharedRef<FJsonValue>& JsonValue, void* Value) {
@@ -121,6 +422,12 @@ void UPropertySerializer::DeserializePropertyValue(FProperty* Property, const TS
 }
 
 void UPropertySerializer::DeserializePropertyValueInner(FProperty* Property, const TSharedRef<FJsonValue>& JsonValue, void* Value) {
+	// Off the game thread, object references are left for ResolveFixups
+	if (DeferredFixups != nullptr && IsDeferredProperty(Property)) {
+		DeferredFixups->Add({ Property, JsonValue, Value });
+		return;
+	}
+
 	const FMapProperty* MapProperty = CastField<const FMapProperty>(Property);
 	const FSetProperty* SetProperty = CastField<const FSetProperty>(Property);
 	const FArrayProperty* ArrayProperty = CastField<const FArrayProperty>(Property);
@@ -172,12 +479,13 @@ void UPropertySerializer::DeserializePropertyValueInner(FProperty* Property, con
 		FProperty* ElementProperty = ArrayProperty->Inner;
 		FScriptArrayHelper ArrayHelper(ArrayProperty, Value);
 		const TArray<TSharedPtr<FJsonValue>>& SetArray = NewJsonValue->AsArray();
-		ArrayHelper.EmptyValues();
+
+		// Sized once, elements don't move while they are filled (deferred fixups point into them)
+		ArrayHelper.EmptyAndAddValues(SetArray.Num());
 
 		for (int32 i = 0; i < SetArray.Num(); i++) {
 			const TSharedPtr<FJsonValue>& Element = SetArray[i];
-			const uint32 AddedIndex = ArrayHelper.AddValue();
-			uint8* ValuePtr = ArrayHelper.GetRawPtr(AddedIndex);
+			uint8* ValuePtr = ArrayHelper.GetRawPtr(i);
 			DeserializePropertyValue(ElementProperty, Element.ToSharedRef(), ValuePtr);
 		}
 	}
@@ -205,21 +513,17 @@ void UPropertySerializer::DeserializePropertyValueInner(FProperty* Property, con
 		TObjectPtr<UObject> Object = NULL;
 
 		// Use IImporter to import the object
-		IImporter* Importer = new IImporter();
-		Importer->LoadObject(&NewJsonValue->AsObject(), Object);
+		IImporter Importer;
+		Importer.LoadObject(&NewJsonValue->AsObject(), Object);
 		ObjectProperty->SetObjectPropertyValue(Value, Object);
 	}
 	else if (const FStructProperty* StructProperty = CastField<const FStructProperty>(Property)) {
-		// JSON for FGuids are FStrings
-		if (FString OutString; JsonValue->TryGetString(OutString)) {
-			FGuid GUID = FGuid(OutString); // Create GUID from String
-
-			TSharedRef<FJsonObject> SharedObject = MakeShareable(new FJsonObject());
-			SharedObject->SetNumberField("A", GUID.A); SharedObject->SetNumberField("B", GUID.B);
-			SharedObject->SetNumberField("C", GUID.C); SharedObject->SetNumberField("D", GUID.D);
+		// JSON for FGuids are FStrings, parsed straight into the property
+		if (JsonValue->Type == EJson::String) {
+			if (StructProperty->Struct == TBaseStructure<FGuid>::Get() && !FGuid::Parse(JsonValue->AsString(), *static_cast<FGuid*>(Value)))
+				static_cast<FGuid*>(Value)->Invalidate();
 
-			const TSharedRef<FJsonValue> NewValue = MakeShareable(new FJsonValueObject(SharedObject));
-			NewJsonValue = NewValue;
+			return;
 		}
 
 		// To serialize struct, we need it's type and value pointer, because struct value doesn't contain type information
@@ -229,7 +533,7 @@ void UPropertySerializer::DeserializePropertyValueInner(FProperty* Property, con
 		// If we have a string provided, make sure Enum is not null
 		if (JsonValue->Type == EJson::String) {
 			check(ByteProperty->Enum);
-			const int64 EnumerationValue = ByteProperty->Enum->GetValueByNameString(NewJsonValue->AsString());
+			const int64 EnumerationValue = FEnumUtilities::GetValue(ByteProperty->Enum, NewJsonValue->AsString());
 			ByteProperty->SetIntPropertyValue(Value, EnumerationValue);
 		}
 		else {
@@ -256,7 +560,7 @@ void UPropertySerializer::DeserializePropertyValueInner(FProperty* Property, con
 	else if (const FEnumProperty* EnumProperty = CastField<const FEnumProperty>(Property)) {
 		// Prefer readable enum names in result json to raw numbers
 		const FString EnumName = NewJsonValue->AsString();
-		const int64 UnderlyingValue = EnumProperty->GetEnum()->GetValueByNameString(EnumName);
+		const int64 UnderlyingValue = FEnumUtilities::GetValue(EnumProperty->GetEnum(), EnumName);
 		if (ensure(UnderlyingValue != INDEX_NONE)) {
 			EnumProperty->GetUnderlyingProperty()->SetIntPropertyValue(Value, UnderlyingValue);
 		}
@@ -492,6 +796,26 @@ void UPropertySerializer::DeserializeStruct(UScriptStruct* Struct, const TShared
 	StructSerializer->Deserialize(Struct, OutValue, Properties);
 }
 
+void UPropertySerializer::DeserializeStructDeferred(UScriptStruct* Struct, const TSharedRef<FJsonObject>& Properties, void* OutValue, TArray<FPropertyFixup>& OutFixups) {
+	check(DeferredFixups == nullptr);
+
+	TGuardValue<TArray<FPropertyFixup>*> DeferredFixupsGuard(DeferredFixups, &OutFixups);
+	DeserializeStruct(Struct, Properties, OutValue);
+}
+
+void UPropertySerializer::ResolveFixups(const TArray<FPropertyFixup>& Fixups) {
+	check(IsInGameThread());
+
+	for (const FPropertyFixup& Fixup : Fixups) {
+		DeserializePropertyValueInner(Fixup.Property, Fixup.JsonValue.ToSharedRef(), Fixup.Value);
+	}
+}
+
+bool UPropertySerializer::CanDeserializeStructDeferred(const UStruct* Struct) {
+	TSet<const UStruct*> VisitedStructs;
+	return CanDeferStructReferences(Struct, VisitedStructs);
+}
+
 bool UPropertySerializer::ComparePropertyValues(FProperty* Property, const TSharedRef<FJsonValue>& JsonValue, const void* CurrentValue, const TSharedPtr<FObjectCompareContext> Context) {
 
 	if (Property->ArrayDim != 1) {
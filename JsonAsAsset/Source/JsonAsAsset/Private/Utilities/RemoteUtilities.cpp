@@ -14,6 +14,10 @@ TSharedPtr<IHttpResponse, ESPMode::ThreadSafe> FRemoteUtilities::ExecuteRequestS
 		return nullptr;
 	}
 
+	return WaitForRequest(HttpRequest, LoopDelay);
+}
+
+TSharedPtr<IHttpResponse, ESPMode::ThreadSafe> FRemoteUtilities::WaitForRequest(TSharedRef<IHttpRequest> HttpRequest, float LoopDelay) {
 	double LastTime = FPlatformTime::Seconds();
 	while (EHttpRequestStatus::Processing == HttpRequest->GetStatus()) {
 		const double AppTime = FPlatformTime::Seconds();
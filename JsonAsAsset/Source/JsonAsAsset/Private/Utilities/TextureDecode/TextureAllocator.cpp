@@ -0,0 +1,52 @@
+#include "TextureAllocator.h"
+
+#include "detex.h"
+#include "nvcore/Memory.h"
+
+#undef __FUNC__						// conflicted with our guard macros
+
+// Per thread, concurrent decodes (and the other textures' stripes) don't show up in each other's counts
+static thread_local int64 DecoderAllocations = 0;
+
+static void* DetexMalloc(const size_t Size, void* UserData) {
+	++DecoderAllocations;
+	return FMemory::Malloc(Size);
+}
+
+static void DetexFree(void* Ptr, void* UserData) {
+	FMemory::Free(Ptr);
+}
+
+static void* NVTTRealloc(void* Ptr, const size_t Size, void* UserData) {
+	if (Size == 0) {
+		FMemory::Free(Ptr);
+		return nullptr;
+	}
+
+	++DecoderAllocations;
+	return FMemory::Realloc(Ptr, Size);
+}
+
+void InstallDecoderAllocators() {
+	detexSetAllocator(DetexMalloc, DetexFree, nullptr);
+	nv::mem::setAllocator(NVTTRealloc, nullptr);
+}
+
+void UninstallDecoderAllocators() {
+	detexSetAllocator(nullptr, nullptr, nullptr);
+	nv::mem::setAllocator(nullptr, nullptr);
+}
+
+int64 GetDecoderAllocationCount() {
+	return DecoderAllocations;
+}
+
+uint8* GetDecoderScratch(const int64 Size) {
+	// Grows to the largest request seen on the thread, never shrinks
+	static thread_local TArray64<uint8> Scratch;
+
+	if (Scratch.Num() < Size)
+		Scratch.SetNumUninitialized(Size);
+
+	return Scratch.GetData();
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+* Allocations made inside the decoders (detex's conversion buffers, NVTT's images and
+* containers) go through FMemory, where they're counted for the decode logs.
+*/
+void InstallDecoderAllocators();
+
+// Back to the decoders' own allocators, before the module unloads
+void UninstallDecoderAllocators();
+
+// Allocations the decoders made so far on the calling thread, take the difference around a decode on it
+int64 GetDecoderAllocationCount();
+
+// Memory of the calling thread, reused by every decode on it, valid until its next call
+uint8* GetDecoderScratch(int64 Size);
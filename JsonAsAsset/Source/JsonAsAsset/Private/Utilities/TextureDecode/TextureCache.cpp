@@ -0,0 +1,219 @@
+#include "TextureCache.h"
+
+#include "HAL/FileManager.h"
+#include "Hash/CityHash.h"
+#include "JsonGlobals.h"
+#include "Misc/Compression.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Settings/JsonAsAssetSettings.h"
+
+// Bumped whenever a decoder's output changes, entries of older versions are never hit
+static constexpr uint32 CacheVersion = 1;
+static constexpr uint32 CacheMagic = 0x5441414A;
+
+struct FCacheHeader {
+	uint32 Magic;
+	uint32 Version;
+	int64 DecodedSize;
+	int64 CompressedSize;
+};
+
+struct FCacheEntry {
+	int64 FileSize = 0;
+	FDateTime LastAccess;
+};
+
+// Index of the cache directory, scanned on first use
+static FCriticalSection CacheLock;
+static TMap<uint64, FCacheEntry> CacheEntries;
+static int64 CacheSize = 0;
+static bool bCacheScanned = false;
+
+static FString GetCacheDirectory() {
+	return FPaths::ProjectSavedDir() / TEXT("JsonAsAsset") / TEXT("TextureCache");
+}
+
+static FString GetCachePath(const uint64 Key) {
+	return GetCacheDirectory() / FString::Printf(TEXT("%016llx.bin"), Key);
+}
+
+// Called with the lock held
+static void ScanCache() {
+	if (bCacheScanned)
+		return;
+
+	bCacheScanned = true;
+
+	// Leftovers of writes that never finished
+	TArray<FString> TempFiles;
+
+	IFileManager::Get().IterateDirectoryStat(*GetCacheDirectory(), [&TempFiles](const TCHAR* Path, const FFileStatData& StatData) {
+		if (StatData.bIsDirectory)
+			return true;
+
+		const FString FileName = FPaths::GetCleanFilename(Path);
+
+		if (FileName.EndsWith(TEXT(".tmp"))) {
+			TempFiles.Add(Path);
+		} else if (FileName.EndsWith(TEXT(".bin"))) {
+			const uint64 Key = FParse::HexNumber64(*FPaths::GetBaseFilename(FileName));
+
+			CacheEntries.Add(Key, { StatData.FileSize, StatData.ModificationTime });
+			CacheSize += StatData.FileSize;
+		}
+
+		return true;
+	});
+
+	for (const FString& TempFile : TempFiles)
+		IFileManager::Get().Delete(*TempFile, false, false, true);
+}
+
+// Called with the lock held, removes the least recently used entries until the cache fits
+static void EvictCache(const int64 MaxSize) {
+	if (CacheSize <= MaxSize)
+		return;
+
+	TArray<TPair<uint64, FCacheEntry>> Entries = CacheEntries.Array();
+	Entries.Sort([](const TPair<uint64, FCacheEntry>& A, const TPair<uint64, FCacheEntry>& B) {
+		return A.Value.LastAccess < B.Value.LastAccess;
+	});
+
+	int32 NumEvicted = 0;
+	for (const TPair<uint64, FCacheEntry>& Entry : Entries) {
+		if (CacheSize <= MaxSize)
+			break;
+
+		IFileManager::Get().Delete(*GetCachePath(Entry.Key), false, false, true);
+
+		CacheEntries.Remove(Entry.Key);
+		CacheSize -= Entry.Value.FileSize;
+		NumEvicted++;
+	}
+
+	UE_LOG(LogJson, Log, TEXT("Evicted %d decoded textures from the cache (%.1f MB left)"), NumEvicted, CacheSize / (1024.0 * 1024.0));
+}
+
+bool IsTextureCacheEnabled() {
+	return GetDefault<UJsonAsAssetSettings>()->bCacheDecodedTextures;
+}
+
+uint64 GetTextureCacheKey(const uint8* Data, const int64 Size, const int SizeX, const int SizeY, const EPixelFormat Format) {
+	uint64 Hash = static_cast<uint64>(CacheVersion) << 56 ^ static_cast<uint64>(Format) << 48 ^ static_cast<uint64>(SizeX) << 24 ^ static_cast<uint64>(SizeY);
+
+	// CityHash takes 32-bit lengths, chained over larger data
+	constexpr int64 MaxHashedSize = 1 << 30;
+
+	for (int64 Offset = 0; Offset < Size; Offset += MaxHashedSize) {
+		const int64 HashedSize = FMath::Min(MaxHashedSize, Size - Offset);
+		Hash = CityHash64WithSeed(reinterpret_cast<const char*>(Data + Offset), static_cast<uint32>(HashedSize), Hash);
+	}
+
+	return Hash;
+}
+
+bool LoadCachedTexture(const uint64 Key, uint8* OutData, const int64 DecodedSize) {
+	// LZ4 works on 32-bit sizes, larger slices are never stored
+	if (DecodedSize > MAX_int32)
+		return false;
+
+	{
+		FScopeLock ScopeLock(&CacheLock);
+		ScanCache();
+
+		if (!CacheEntries.Contains(Key))
+			return false;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const FString Path = GetCachePath(Key);
+
+	TArray64<uint8> File;
+	FCacheHeader Header;
+
+	bool bLoaded = FFileHelper::LoadFileToArray(File, *Path, FILEREAD_Silent) && File.Num() >= static_cast<int64>(sizeof(FCacheHeader));
+	if (bLoaded) {
+		FMemory::Memcpy(&Header, File.GetData(), sizeof(FCacheHeader));
+
+		bLoaded = Header.Magic == CacheMagic && Header.Version == CacheVersion &&
+			Header.DecodedSize == DecodedSize && Header.CompressedSize == File.Num() - static_cast<int64>(sizeof(FCacheHeader)) &&
+			FCompression::UncompressMemory(NAME_LZ4, OutData, static_cast<int32>(DecodedSize), File.GetData() + sizeof(FCacheHeader), static_cast<int32>(Header.CompressedSize));
+	}
+
+	if (!bLoaded) {
+		UE_LOG(LogJson, Warning, TEXT("Dropping unreadable decoded texture from the cache (%s)"), *Path);
+
+		FScopeLock ScopeLock(&CacheLock);
+		if (const FCacheEntry* Entry = CacheEntries.Find(Key)) {
+			CacheSize -= Entry->FileSize;
+			CacheEntries.Remove(Key);
+		}
+
+		IFileManager::Get().Delete(*Path, false, false, true);
+
+		return false;
+	}
+
+	// Access time is kept on the file itself, so the order survives across sessions
+	const FDateTime Now = FDateTime::UtcNow();
+	IFileManager::Get().SetTimeStamp(*Path, Now);
+
+	{
+		FScopeLock ScopeLock(&CacheLock);
+		if (FCacheEntry* Entry = CacheEntries.Find(Key))
+			Entry->LastAccess = Now;
+	}
+
+	UE_LOG(LogJson, Log, TEXT("Loaded decoded texture from the cache in %.2f ms (%.1f MB)"), (FPlatformTime::Seconds() - StartTime) * 1000.0, DecodedSize / (1024.0 * 1024.0));
+
+	return true;
+}
+
+void StoreCachedTexture(const uint64 Key, const uint8* Data, const int64 DecodedSize) {
+	if (DecodedSize > MAX_int32)
+		return;
+
+	{
+		FScopeLock ScopeLock(&CacheLock);
+		ScanCache();
+
+		if (CacheEntries.Contains(Key))
+			return;
+	}
+
+	int32 CompressedSize = FCompression::CompressMemoryBound(NAME_LZ4, static_cast<int32>(DecodedSize));
+
+	TArray64<uint8> File;
+	File.SetNumUninitialized(sizeof(FCacheHeader) + CompressedSize);
+
+	if (!FCompression::CompressMemory(NAME_LZ4, File.GetData() + sizeof(FCacheHeader), CompressedSize, Data, static_cast<int32>(DecodedSize)))
+		return;
+
+	File.SetNum(sizeof(FCacheHeader) + CompressedSize, false);
+
+	const FCacheHeader Header = { CacheMagic, CacheVersion, DecodedSize, CompressedSize };
+	FMemory::Memcpy(File.GetData(), &Header, sizeof(FCacheHeader));
+
+	// Written aside and moved in place, so a reader never sees a partial entry
+	const FString Path = GetCachePath(Key);
+	const FString TempPath = Path + TEXT(".") + FGuid::NewGuid().ToString() + TEXT(".tmp");
+
+	if (!FFileHelper::SaveArrayToFile(File, *TempPath) || !IFileManager::Get().Move(*Path, *TempPath, true, true, false, true)) {
+		IFileManager::Get().Delete(*TempPath, false, false, true);
+		return;
+	}
+
+	const int64 MaxSize = static_cast<int64>(GetDefault<UJsonAsAssetSettings>()->TextureCacheSize) * 1024 * 1024;
+
+	FScopeLock ScopeLock(&CacheLock);
+	if (const FCacheEntry* Entry = CacheEntries.Find(Key))
+		CacheSize -= Entry->FileSize;
+
+	CacheEntries.Add(Key, { File.Num(), FDateTime::UtcNow() });
+	CacheSize += File.Num();
+
+	EvictCache(MaxSize);
+}
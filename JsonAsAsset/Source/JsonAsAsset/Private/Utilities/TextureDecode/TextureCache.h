@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Engine/Texture.h"
+
+/*
+* Decoded texture sources, kept on disk between imports (Saved/JsonAsAsset/TextureCache).
+* Re-importing a texture decodes the same compressed data again, this skips the decode.
+*
+* Entries are keyed by a hash of the compressed slice, its pixel format and dimensions,
+* and stored LZ4 compressed. Past the size cap in the settings, the least recently used
+* entries are evicted. Safe to use from any thread.
+*/
+
+// False if the cache is turned off in the settings
+bool IsTextureCacheEnabled();
+
+// Key of a compressed slice, along with what it is decoded as
+uint64 GetTextureCacheKey(const uint8* Data, int64 Size, int SizeX, int SizeY, EPixelFormat Format);
+
+// Fills OutData (DecodedSize bytes) with a cached decode, false on a miss
+bool LoadCachedTexture(uint64 Key, uint8* OutData, int64 DecodedSize);
+
+// Stores a decoded slice, evicting the least recently used entries if needed
+void StoreCachedTexture(uint64 Key, const uint8* Data, int64 DecodedSize);
@@ -0,0 +1,173 @@
+#include "TextureDDS.h"
+
+#include "RenderUtils.h"
+
+// Offsets in the file, past the "DDS " magic
+static constexpr int64 HeaderSize = 4 + 124;
+static constexpr int64 DX10HeaderSize = 20;
+
+static constexpr uint32 DDSD_DEPTH = 0x800000;
+static constexpr uint32 DDPF_ALPHAPIXELS = 0x1;
+static constexpr uint32 DDPF_FOURCC = 0x4;
+static constexpr uint32 DDPF_RGB = 0x40;
+static constexpr uint32 DDPF_LUMINANCE = 0x20000;
+static constexpr uint32 DDSCAPS2_CUBEMAP = 0x200;
+static constexpr uint32 DDSCAPS2_VOLUME = 0x200000;
+static constexpr uint32 DDS_RESOURCE_MISC_TEXTURECUBE = 0x4;
+static constexpr uint32 DDS_DIMENSION_TEXTURE3D = 4;
+
+static constexpr uint32 MakeFourCC(const char A, const char B, const char C, const char D) {
+	return static_cast<uint32>(A) | static_cast<uint32>(B) << 8 | static_cast<uint32>(C) << 16 | static_cast<uint32>(D) << 24;
+}
+
+static uint32 ReadUInt32(const uint8* Data, const int64 Offset) {
+	uint32 Value;
+	FMemory::Memcpy(&Value, Data + Offset, sizeof(uint32));
+
+	return Value;
+}
+
+static EPixelFormat GetFourCCPixelFormat(const uint32 FourCC) {
+	switch (FourCC) {
+	case MakeFourCC('D', 'X', 'T', '1'): return PF_DXT1;
+	case MakeFourCC('D', 'X', 'T', '2'):
+	case MakeFourCC('D', 'X', 'T', '3'): return PF_DXT3;
+	case MakeFourCC('D', 'X', 'T', '4'):
+	case MakeFourCC('D', 'X', 'T', '5'): return PF_DXT5;
+	case MakeFourCC('A', 'T', 'I', '1'):
+	case MakeFourCC('B', 'C', '4', 'U'): return PF_BC4;
+	case MakeFourCC('A', 'T', 'I', '2'):
+	case MakeFourCC('B', 'C', '5', 'U'): return PF_BC5;
+
+	// D3DFMT_A16B16G16R16F and D3DFMT_A32B32G32R32F
+	case 113: return PF_FloatRGBA;
+	case 116: return PF_A32B32G32R32F;
+	default: return PF_Unknown;
+	}
+}
+
+static EPixelFormat GetDXGIPixelFormat(const uint32 Format) {
+	switch (Format) {
+	case 2: return PF_A32B32G32R32F;
+	case 10: return PF_FloatRGBA;
+	case 28:
+	case 29: return PF_R8G8B8A8;
+	case 34: return PF_G16R16F;
+	case 49: return PF_R8G8;
+	case 54: return PF_R16F;
+	case 56: return PF_G16;
+	case 61: return PF_G8;
+	case 71:
+	case 72: return PF_DXT1;
+	case 74:
+	case 75: return PF_DXT3;
+	case 77:
+	case 78: return PF_DXT5;
+	case 80: return PF_BC4;
+	case 83: return PF_BC5;
+	case 87:
+	case 91: return PF_B8G8R8A8;
+	case 95: return PF_BC6H;
+	case 98:
+	case 99: return PF_BC7;
+	default: return PF_Unknown;
+	}
+}
+
+// Uncompressed formats without a FourCC, told apart by their channel masks
+static EPixelFormat GetMaskedPixelFormat(const uint32 Flags, const uint32 BitCount, const uint32 RedMask, const uint32 GreenMask, const uint32 BlueMask) {
+	if ((Flags & DDPF_LUMINANCE) && BitCount == 8)
+		return PF_G8;
+
+	if ((Flags & DDPF_RGB) && BitCount == 32) {
+		if (RedMask == 0x00FF0000 && GreenMask == 0x0000FF00 && BlueMask == 0x000000FF) return PF_B8G8R8A8;
+		if (RedMask == 0x000000FF && GreenMask == 0x0000FF00 && BlueMask == 0x00FF0000) return PF_R8G8B8A8;
+	}
+
+	return PF_Unknown;
+}
+
+bool ParseDDS(const uint8* Data, const int64 Size, FDDSLayout& OutLayout) {
+	if (Size < HeaderSize || ReadUInt32(Data, 0) != MakeFourCC('D', 'D', 'S', ' ') || ReadUInt32(Data, 4) != 124)
+		return false;
+
+	const uint32 HeaderFlags = ReadUInt32(Data, 8);
+	OutLayout.SizeY = ReadUInt32(Data, 12);
+	OutLayout.SizeX = ReadUInt32(Data, 16);
+	OutLayout.SizeZ = HeaderFlags & DDSD_DEPTH ? FMath::Max<int32>(1, ReadUInt32(Data, 24)) : 1;
+	OutLayout.NumMips = FMath::Max<int32>(1, ReadUInt32(Data, 28));
+
+	const uint32 FormatFlags = ReadUInt32(Data, 80);
+	const uint32 FourCC = ReadUInt32(Data, 84);
+	const uint32 Caps2 = ReadUInt32(Data, 112);
+
+	OutLayout.bCubemap = (Caps2 & DDSCAPS2_CUBEMAP) != 0;
+	OutLayout.bVolume = (Caps2 & DDSCAPS2_VOLUME) != 0 && OutLayout.SizeZ > 1;
+	OutLayout.NumSlices = OutLayout.bCubemap ? 6 : 1;
+	OutLayout.DataOffset = HeaderSize;
+
+	if ((FormatFlags & DDPF_FOURCC) && FourCC == MakeFourCC('D', 'X', '1', '0')) {
+		if (Size < HeaderSize + DX10HeaderSize)
+			return false;
+
+		const uint32 Dimension = ReadUInt32(Data, HeaderSize + 4);
+		const uint32 MiscFlags = ReadUInt32(Data, HeaderSize + 8);
+		const int64 ArraySize = FMath::Max<int64>(1, ReadUInt32(Data, HeaderSize + 12));
+
+		OutLayout.PixelFormat = GetDXGIPixelFormat(ReadUInt32(Data, HeaderSize));
+		OutLayout.bCubemap = (MiscFlags & DDS_RESOURCE_MISC_TEXTURECUBE) != 0;
+		OutLayout.bVolume = Dimension == DDS_DIMENSION_TEXTURE3D;
+
+		// Counted wide, a bogus array size times 6 faces would wrap around in 32 bits
+		const int64 NumSlices = ArraySize * (OutLayout.bCubemap ? 6 : 1);
+		if (NumSlices > MAX_int32)
+			return false;
+
+		OutLayout.NumSlices = static_cast<int32>(NumSlices);
+		OutLayout.DataOffset += DX10HeaderSize;
+	} else if (FormatFlags & DDPF_FOURCC) {
+		OutLayout.PixelFormat = GetFourCCPixelFormat(FourCC);
+	} else {
+		OutLayout.PixelFormat = GetMaskedPixelFormat(FormatFlags & ~DDPF_ALPHAPIXELS, ReadUInt32(Data, 88), ReadUInt32(Data, 92), ReadUInt32(Data, 96), ReadUInt32(Data, 100));
+	}
+
+	if (!OutLayout.bVolume)
+		OutLayout.SizeZ = 1;
+
+	if (OutLayout.PixelFormat == PF_Unknown || OutLayout.SizeX <= 0 || OutLayout.SizeY <= 0)
+		return false;
+
+	// Past the 1x1 mip, the count is garbage (and every offset would walk the whole chain for it)
+	OutLayout.NumMips = FMath::Min(OutLayout.NumMips, static_cast<int32>(FMath::FloorLog2(FMath::Max(OutLayout.SizeX, OutLayout.SizeY))) + 1);
+
+	// Everything the headers describe has to be in the file
+	const int64 LastSlice = OutLayout.bVolume ? OutLayout.SizeZ - 1 : OutLayout.NumSlices - 1;
+	return GetDDSSurfaceOffset(OutLayout, LastSlice, 0) + GetDDSSurfaceSize(OutLayout, 0) <= Size;
+}
+
+int64 GetDDSSurfaceSize(const FDDSLayout& Layout, const int32 Mip) {
+	const FPixelFormatInfo& Info = GPixelFormats[Layout.PixelFormat];
+
+	const int32 MipSizeX = FMath::Max(1, Layout.SizeX >> Mip);
+	const int32 MipSizeY = FMath::Max(1, Layout.SizeY >> Mip);
+
+	return static_cast<int64>(FMath::DivideAndRoundUp(MipSizeX, Info.BlockSizeX)) * FMath::DivideAndRoundUp(MipSizeY, Info.BlockSizeY) * Info.BlockBytes;
+}
+
+int64 GetDDSSurfaceOffset(const FDDSLayout& Layout, const int32 Slice, const int32 Mip) {
+	// Volumes store every depth slice of a mip together, the top mip comes first
+	if (Layout.bVolume)
+		return Layout.DataOffset + Slice * GetDDSSurfaceSize(Layout, 0);
+
+	int64 ChainSize = 0;
+	int64 MipOffset = 0;
+
+	for (int32 MipIndex = 0; MipIndex < Layout.NumMips; MipIndex++) {
+		if (MipIndex == Mip)
+			MipOffset = ChainSize;
+
+		ChainSize += GetDDSSurfaceSize(Layout, MipIndex);
+	}
+
+	return Layout.DataOffset + Slice * ChainSize + MipOffset;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Engine/Texture.h"
+
+// Layout of a DDS file in memory, surfaces are stored slice by slice, each with its mip chain
+struct FDDSLayout {
+	EPixelFormat PixelFormat = PF_Unknown;
+
+	int32 SizeX = 0;
+	int32 SizeY = 0;
+
+	// Depth of volume textures, 1 otherwise
+	int32 SizeZ = 1;
+
+	// Array layers times cube faces
+	int32 NumSlices = 1;
+	int32 NumMips = 1;
+
+	bool bCubemap = false;
+	bool bVolume = false;
+
+	// Offset of the first surface, past the headers
+	int64 DataOffset = 0;
+};
+
+/*
+* Parses the headers of a DDS file (legacy, and DX10 for BC6H/BC7 and arrays) into the
+* pixel format it's imported as. False if it isn't a DDS file, or a format we can't decode.
+*/
+bool ParseDDS(const uint8* Data, int64 Size, FDDSLayout& OutLayout);
+
+// Offset of a mip of a slice (of a depth slice of the top mip, for volume textures)
+int64 GetDDSSurfaceOffset(const FDDSLayout& Layout, int32 Slice, int32 Mip);
+
+// Size of one surface of a mip
+int64 GetDDSSurfaceSize(const FDDSLayout& Layout, int32 Mip);
@@ -0,0 +1,145 @@
+#include "TextureDetex.h"
+
+#include "TextureAllocator.h"
+#include "Async/ParallelFor.h"
+#include "JsonGlobals.h"
+
+#include <atomic>
+
+// Block rows per stripe, enough work per task to hide the scheduling cost
+static constexpr int32 BlockRowsPerStripe = 8;
+
+// Values per task when converting between float and half-float (a 1K RGBA row block)
+static constexpr int64 ValuesPerChunk = 256 * 1024;
+
+// 16-bit red (R11) or red/green (RG11) to BGRA8, same layout as our PF_G8 / BC5 imports
+static void ExpandToBGRA8(const uint8* Source, uint8* Dest, const int32 NumPixels, const uint32 SourceFormat) {
+	const uint16* Pixels = reinterpret_cast<const uint16*>(Source);
+
+	if (SourceFormat == DETEX_PIXEL_FORMAT_R16) {
+		for (int32 i = 0; i < NumPixels; i++) {
+			const uint8 R = Pixels[i] >> 8;
+			*Dest++ = R;
+			*Dest++ = R;
+			*Dest++ = R;
+			*Dest++ = 255;
+		}
+	} else {
+		for (int32 i = 0; i < NumPixels; i++) {
+			*Dest++ = 0;
+			*Dest++ = Pixels[i * 2 + 1] >> 8;
+			*Dest++ = Pixels[i * 2] >> 8;
+			*Dest++ = 255;
+		}
+	}
+}
+
+// Formats with their own kernels writing BGRA8 rows (same output as NVTT)
+static bool HasBGRA8Kernels(const uint32 TextureFormat) {
+	switch (TextureFormat) {
+	case DETEX_TEXTURE_FORMAT_BC1:
+	case DETEX_TEXTURE_FORMAT_BC1A:
+	case DETEX_TEXTURE_FORMAT_BC2:
+	case DETEX_TEXTURE_FORMAT_BC3:
+	case DETEX_TEXTURE_FORMAT_RGTC1:
+	case DETEX_TEXTURE_FORMAT_RGTC2:
+		return true;
+	default:
+		return false;
+	}
+}
+
+bool DecodeDetex(const uint8* Data, uint8* OutData, const int SizeX, const int SizeY, const uint32 TextureFormat, const uint32 PixelFormat, const uint32 Flags) {
+	const double StartTime = FPlatformTime::Seconds();
+
+	detexTexture Texture;
+	Texture.data = const_cast<uint8*>(Data);
+	Texture.format = TextureFormat;
+	Texture.width = SizeX;
+	Texture.height = SizeY;
+	Texture.width_in_blocks = FMath::DivideAndRoundUp(SizeX, 4);
+	Texture.height_in_blocks = FMath::DivideAndRoundUp(SizeY, 4);
+
+	// detex has no conversion from 16-bit single/dual channel to BGRA8, decoded natively and expanded here
+	const uint32 NativeFormat = detexGetPixelFormat(TextureFormat);
+	const bool bExpand = PixelFormat == DETEX_PIXEL_FORMAT_BGRA8 && (NativeFormat == DETEX_PIXEL_FORMAT_R16 || NativeFormat == DETEX_PIXEL_FORMAT_RG16);
+
+	const bool bBGRA8Kernels = PixelFormat == DETEX_PIXEL_FORMAT_BGRA8 && HasBGRA8Kernels(TextureFormat);
+
+	const uint32 DecodeFormat = bExpand ? NativeFormat : PixelFormat;
+	const int32 RowSize = SizeX * detexGetPixelSize(PixelFormat);
+
+	const int32 NumStripes = FMath::DivideAndRoundUp(Texture.height_in_blocks, BlockRowsPerStripe);
+	std::atomic<bool> bSucceeded = true;
+
+	// Summed from every stripe, whatever thread it ran on
+	std::atomic<int64> NumAllocations = 0;
+
+	FCriticalSection ErrorLock;
+	FString Error;
+
+	ParallelFor(NumStripes, [&](const int32 Stripe) {
+		const int64 StartAllocations = GetDecoderAllocationCount();
+
+		// Own context per stripe, nothing in detex is shared between the tasks
+		detexContext Context;
+		detexInitContext(&Context);
+
+		const int32 FirstBlockRow = Stripe * BlockRowsPerStripe;
+		const int32 NumBlockRows = FMath::Min(BlockRowsPerStripe, Texture.height_in_blocks - FirstBlockRow);
+		const int32 NumRows = FMath::Min(SizeY, (FirstBlockRow + NumBlockRows) * 4) - FirstBlockRow * 4;
+
+		uint8* StripeData = OutData + static_cast<int64>(FirstBlockRow) * 4 * RowSize;
+
+		if (bBGRA8Kernels) {
+			if (!detexDecompressTextureRowsBGRA8(&Texture, StripeData, RowSize, FirstBlockRow, NumBlockRows, Flags))
+				bSucceeded = false;
+		} else if (bExpand) {
+			uint8* Native = GetDecoderScratch(static_cast<int64>(SizeX) * NumRows * detexGetPixelSize(NativeFormat));
+
+			if (!detexDecompressTextureLinearRowsWithContext(&Context, &Texture, Native, DecodeFormat, FirstBlockRow, NumBlockRows))
+				bSucceeded = false;
+
+			ExpandToBGRA8(Native, StripeData, SizeX * NumRows, NativeFormat);
+		} else if (!detexDecompressTextureLinearRowsWithContext(&Context, &Texture, StripeData, DecodeFormat, FirstBlockRow, NumBlockRows)) {
+			bSucceeded = false;
+		}
+
+		if (const char* Message = detexGetContextErrorMessage(&Context)) {
+			FScopeLock ScopeLock(&ErrorLock);
+			if (Error.IsEmpty()) Error = UTF8_TO_TCHAR(Message);
+		}
+
+		NumAllocations += GetDecoderAllocationCount() - StartAllocations;
+	});
+
+	if (!Error.IsEmpty()) {
+		UE_LOG(LogJson, Warning, TEXT("detex: %s"), *Error);
+	}
+
+	const double Seconds = FPlatformTime::Seconds() - StartTime;
+	UE_LOG(LogJson, Log, TEXT("Decoded %s %dx%d in %.2f ms (%.1f MPixels/s, %d stripes, %lld allocations)"),
+		UTF8_TO_TCHAR(detexGetTextureFormatText(TextureFormat)), SizeX, SizeY, Seconds * 1000.0,
+		static_cast<double>(SizeX) * SizeY / FMath::Max(Seconds, 1e-6) / 1e6, NumStripes, NumAllocations.load()
+	);
+
+	return bSucceeded;
+}
+
+void ConvertFloatToHalf(const float* Data, uint16* OutData, const int64 Num) {
+	const double StartTime = FPlatformTime::Seconds();
+
+	const int32 NumChunks = static_cast<int32>(FMath::DivideAndRoundUp(Num, ValuesPerChunk));
+
+	ParallelFor(NumChunks, [&](const int32 Chunk) {
+		const int64 First = Chunk * ValuesPerChunk;
+		const int32 Count = static_cast<int32>(FMath::Min(ValuesPerChunk, Num - First));
+
+		detexConvertFloatToHalfFloat(const_cast<float*>(Data + First), Count, OutData + First);
+	});
+
+	const double Seconds = FPlatformTime::Seconds() - StartTime;
+	UE_LOG(LogJson, Log, TEXT("Converted %lld floats to half-floats in %.2f ms (%.1f MValues/s, %d chunks)"),
+		Num, Seconds * 1000.0, static_cast<double>(Num) / FMath::Max(Seconds, 1e-6) / 1e6, NumChunks
+	);
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "detex.h"
+
+/*
+* Decodes a block compressed texture with detex into a linear buffer of PixelFormat.
+* Rows of blocks are split in stripes, decoded in parallel on the task graph.
+*
+* EAC R11/RG11 (16-bit native) can also be decoded into DETEX_PIXEL_FORMAT_BGRA8.
+* BC1-BC5 to DETEX_PIXEL_FORMAT_BGRA8 go through the SIMD block kernels, which write
+* straight into the output rows (Flags takes DETEX_DECOMPRESS_FLAG_NORMAL_Z for BC5).
+*/
+bool DecodeDetex(const uint8* Data, uint8* OutData, int SizeX, int SizeY, uint32 TextureFormat, uint32 PixelFormat, uint32 Flags = 0);
+
+/*
+* Converts 32-bit floats to half-floats (PF_A32B32G32R32F to TSF_RGBA16F), in parallel
+* chunks through detex's vectorized conversion.
+*/
+void ConvertFloatToHalf(const float* Data, uint16* OutData, int64 Num);
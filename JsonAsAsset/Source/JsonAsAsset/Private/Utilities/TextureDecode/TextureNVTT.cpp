@@ -1,93 +1,48 @@
 #include "TextureNVTT.h"
 
-#include "nvcore/Stream.h"
-
-class NVTTStream : public nv::Stream {
-public:
-	NVTTStream(uint8* mem0, uint size0, uint8* mem1, uint size1, bool isLoading)
-		: m_mem0(mem0)
-		  , m_mem1(mem1)
-		  , m_pos(0)
-		  , m_size0(size0)
-		  , m_size1(size1)
-		  , m_loading(isLoading) {
-	}
-
-	virtual uint serialize(void* data, uint len) {
-		nvDebugCheck(!isError());
-
-		uint left;
-		uint8* ptr;
-		if (m_pos < m_size0) {
-			left = m_size0 - m_pos;
-			ptr = m_mem0 + m_pos;
-		} else {
-			left = m_size1 - (m_pos - m_size0);
-			ptr = m_mem1 + (m_pos - m_size0);
-		}
-
-		if (len > left) len = left;
-		if (m_loading)
-			FMemory::Memcpy(data, ptr, len);
-		else
-			FMemory::Memcpy(ptr, data, len);
-		m_pos += len;
-
-		return len;
-	}
-
-	virtual void seek(uint pos) {
-		nvDebugCheck(!isError());
-		m_pos = pos;
-		nvDebugCheck(!isError());
-	}
-
-	virtual uint tell() const {
-		nvDebugCheck(m_pos < m_size0 + m_size1);
-		return m_pos;
-	}
-
-	virtual uint size() const {
-		return m_size0 + m_size1;
-	}
-
-	virtual bool isError() const {
-		return m_mem0 == NULL || m_mem1 == NULL || m_pos > m_size0 + m_size1;
-	}
-
-	virtual void clearError() {
-		// Nothing to do.
-	}
-
-	virtual bool isAtEnd() const {
-		return m_pos == m_size0 + m_size1;
-	}
-
-	virtual bool isSeekable() const {
-		return true;
-	}
-
-	virtual bool isLoading() const {
-		return m_loading;
-	}
-
-	virtual bool isSaving() const {
-		return !m_loading;
-	}
-
-private:
-	uint8* m_mem0;
-	uint8* m_mem1;
-	uint m_pos;
-	uint m_size0;
-	uint m_size1;
-	bool m_loading;
-};
-
-void DecodeDDS(const unsigned char* Data, int USize, int VSize, nv::DDSHeader& header, nv::Image& image) {
-	uint8 dummy[128];
-	NVTTStream* stream = new NVTTStream(dummy, sizeof(dummy), const_cast<unsigned char*>(Data), USize * VSize * 4, true); // deleted in DirectDrawSurface destructor
-	nv::DirectDrawSurface dds(stream); // will try to read DDS header, it's zeroed
-	dds.header = header; // set real header contents
-	dds.mipmap(&image, 0, 0);
+#include "JsonGlobals.h"
+#include "TextureAllocator.h"
+#include "nvcore/StdStream.h"
+
+bool DecodeDDS(const uint8* Data, const uint32 Size, const nv::DDSHeader& Header, uint8* OutData) {
+	uint64 BlockBytes;
+	switch (Header.pf.fourcc) {
+	case FOURCC_DXT1:
+	case FOURCC_ATI1:
+		BlockBytes = 8;
+		break;
+	case FOURCC_DXT3:
+	case FOURCC_DXT5:
+	case FOURCC_ATI2:
+		BlockBytes = 16;
+		break;
+	default: return false;
+	}
+
+	// The stream cuts short reads silently, what they didn't fill in would be garbage
+	if (static_cast<uint64>((Header.width + 3) / 4) * ((Header.height + 3) / 4) * BlockBytes > Size)
+		return false;
+
+	const double StartTime = FPlatformTime::Seconds();
+	const int64 StartAllocations = GetDecoderAllocationCount();
+
+	// Blocks are decoded in place, the stream only holds the surface (no file header in front of it)
+	nv::DirectDrawSurface DDS(Header, new nv::MemoryInputStream(Data, Size)); // deleted in DirectDrawSurface destructor
+
+	nv::Image Image;
+	Image.wrap(OutData, Header.width, Header.height);
+	DDS.mipmap(&Image, 0, 0);
+
+	// Only left OutData if it had to allocate, which the first mip never does (never copies past the slice either)
+	if (Image.pixels() == reinterpret_cast<nv::Color32*>(OutData)) {
+		Image.unwrap();
+	} else {
+		const int64 ImageSize = static_cast<int64>(Image.width()) * Image.height() * nv::Image::Color32_Size;
+		FMemory::Memcpy(OutData, Image.pixels(), FMath::Min(ImageSize, static_cast<int64>(Header.width) * Header.height * 4));
+	}
+
+	const double Seconds = FPlatformTime::Seconds() - StartTime;
+	UE_LOG(LogJson, Log, TEXT("Decoded %dx%d with NVTT in %.2f ms (%lld allocations)"), Header.width, Header.height, Seconds * 1000.0, GetDecoderAllocationCount() - StartAllocations);
+
+	return true;
 }
@@ -5,4 +5,9 @@
 
 #undef __FUNC__						// conflicted with our guard macros
 
-void DecodeDDS(const unsigned char* Data, int USize, int VSize, nv::DDSHeader& Header, nv::Image& Image);
+/*
+* Decodes the first surface Header describes, read straight from Data (Size bytes, a HTTP response or a mapped file),
+* to BGRA8 in OutData. NVTT writes into OutData itself, nothing is allocated for the image.
+* False if the header has no block format NVTT knows, or the surface runs past Size.
+*/
+bool DecodeDDS(const uint8* Data, uint32 Size, const nv::DDSHeader& Header, uint8* OutData);
@@ -0,0 +1,430 @@
+#include "TextureSwizzle.h"
+
+#include "Async/ParallelFor.h"
+#include "JsonGlobals.h"
+
+#if PLATFORM_CPU_X86_FAMILY
+	#include <immintrin.h>
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+		#define SWIZZLE_TARGET_AVX2
+	#else
+		#include <cpuid.h>
+		#define SWIZZLE_TARGET_AVX2 __attribute__((target("avx2")))
+	#endif
+#endif
+
+// Pixels per task, enough work per task to hide the scheduling cost (a 512x512 block)
+static constexpr int64 PixelsPerChunk = 256 * 1024;
+
+// 1.0 as a half-float, alpha of the expanded float formats
+static constexpr uint16 HalfOne = 0x3C00;
+
+enum class ESwizzleKernel : uint8 {
+	Copy,
+	G8ToBGRA8,
+	R8G8ToBGRA8,
+	RGBA8ToBGRA8,
+	R16FToRGBA16F,
+	RG16FToRGBA16F,
+	Count
+};
+
+struct FUncompressedFormat {
+	EPixelFormat PixelFormat;
+	ETextureSourceFormat SourceFormat;
+	ESwizzleKernel Kernel;
+
+	int32 SourceBytes;
+	int32 DestBytes;
+};
+
+static const FUncompressedFormat UncompressedFormats[] = {
+	{ PF_B8G8R8A8,         TSF_BGRA8,    ESwizzleKernel::Copy,           4, 4 },
+	{ PF_R8G8B8A8,         TSF_BGRA8,    ESwizzleKernel::RGBA8ToBGRA8,   4, 4 },
+	{ PF_G8,               TSF_BGRA8,    ESwizzleKernel::G8ToBGRA8,      1, 4 },
+	{ PF_L8,               TSF_BGRA8,    ESwizzleKernel::G8ToBGRA8,      1, 4 },
+	{ PF_R8G8,             TSF_BGRA8,    ESwizzleKernel::R8G8ToBGRA8,    2, 4 },
+	{ PF_G16,              TSF_G16,      ESwizzleKernel::Copy,           2, 2 },
+	{ PF_FloatRGBA,        TSF_RGBA16F,  ESwizzleKernel::Copy,           8, 8 },
+	{ PF_R16F,             TSF_RGBA16F,  ESwizzleKernel::R16FToRGBA16F,  2, 8 },
+	{ PF_R16F_FILTER,      TSF_RGBA16F,  ESwizzleKernel::R16FToRGBA16F,  2, 8 },
+	{ PF_G16R16F,          TSF_RGBA16F,  ESwizzleKernel::RG16FToRGBA16F, 4, 8 },
+	{ PF_G16R16F_FILTER,   TSF_RGBA16F,  ESwizzleKernel::RG16FToRGBA16F, 4, 8 },
+};
+
+static const FUncompressedFormat* FindUncompressedFormat(const EPixelFormat Format) {
+	for (const FUncompressedFormat& Entry : UncompressedFormats) {
+		if (Entry.PixelFormat == Format)
+			return &Entry;
+	}
+
+	return nullptr;
+}
+
+/*
+* Scalar kernels, for the pixels left over by the vector ones (and everything off x86).
+*/
+static void ScalarG8ToBGRA8(const uint8* Source, uint8* Dest, const int64 Num) {
+	for (int64 i = 0; i < Num; i++) {
+		const uint8 G = Source[i];
+		*Dest++ = G;
+		*Dest++ = G;
+		*Dest++ = G;
+		*Dest++ = 255;
+	}
+}
+
+static void ScalarR8G8ToBGRA8(const uint8* Source, uint8* Dest, const int64 Num) {
+	for (int64 i = 0; i < Num; i++) {
+		*Dest++ = 0;
+		*Dest++ = Source[i * 2 + 1];
+		*Dest++ = Source[i * 2];
+		*Dest++ = 255;
+	}
+}
+
+static void ScalarRGBA8ToBGRA8(const uint8* Source, uint8* Dest, const int64 Num) {
+	for (int64 i = 0; i < Num; i++) {
+		*Dest++ = Source[i * 4 + 2];
+		*Dest++ = Source[i * 4 + 1];
+		*Dest++ = Source[i * 4];
+		*Dest++ = Source[i * 4 + 3];
+	}
+}
+
+static void ScalarR16FToRGBA16F(const uint8* Source, uint8* Dest, const int64 Num) {
+	const uint16* Pixels = reinterpret_cast<const uint16*>(Source);
+	uint16* Out = reinterpret_cast<uint16*>(Dest);
+
+	for (int64 i = 0; i < Num; i++) {
+		*Out++ = Pixels[i];
+		*Out++ = Pixels[i];
+		*Out++ = Pixels[i];
+		*Out++ = HalfOne;
+	}
+}
+
+static void ScalarRG16FToRGBA16F(const uint8* Source, uint8* Dest, const int64 Num) {
+	const uint16* Pixels = reinterpret_cast<const uint16*>(Source);
+	uint16* Out = reinterpret_cast<uint16*>(Dest);
+
+	for (int64 i = 0; i < Num; i++) {
+		*Out++ = Pixels[i * 2];
+		*Out++ = Pixels[i * 2 + 1];
+		*Out++ = 0;
+		*Out++ = HalfOne;
+	}
+}
+
+#if PLATFORM_CPU_X86_FAMILY
+
+/*
+* SSE2 kernels, part of x64 so always there. Each returns the number of pixels it converted.
+*/
+static int64 SSE2G8ToBGRA8(const uint8* Source, uint8* Dest, const int64 Num) {
+	const __m128i Alpha = _mm_set1_epi32(static_cast<int32>(0xFF000000));
+
+	int64 i = 0;
+	for (; i + 16 <= Num; i += 16) {
+		const __m128i G = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Source + i));
+		const __m128i GG[2] = { _mm_unpacklo_epi8(G, G), _mm_unpackhi_epi8(G, G) };
+
+		__m128i* Out = reinterpret_cast<__m128i*>(Dest + i * 4);
+		for (int32 Half = 0; Half < 2; Half++) {
+			// G G G G -> G G G 255
+			_mm_storeu_si128(Out++, _mm_or_si128(_mm_unpacklo_epi16(GG[Half], GG[Half]), Alpha));
+			_mm_storeu_si128(Out++, _mm_or_si128(_mm_unpackhi_epi16(GG[Half], GG[Half]), Alpha));
+		}
+	}
+
+	return i;
+}
+
+static int64 SSE2R8G8ToBGRA8(const uint8* Source, uint8* Dest, const int64 Num) {
+	const __m128i Alpha = _mm_set1_epi32(static_cast<int32>(0xFF000000));
+	const __m128i Zero = _mm_setzero_si128();
+
+	int64 i = 0;
+	for (; i + 8 <= Num; i += 8) {
+		const __m128i RG = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Source + i * 2));
+
+		// R G -> 0 G R 255, the 16-bit pairs reversed then moved up a byte
+		__m128i* Out = reinterpret_cast<__m128i*>(Dest + i * 4);
+		for (int32 Half = 0; Half < 2; Half++) {
+			const __m128i Pixels = Half == 0 ? _mm_unpacklo_epi16(RG, Zero) : _mm_unpackhi_epi16(RG, Zero);
+			const __m128i R = _mm_slli_epi32(_mm_and_si128(Pixels, _mm_set1_epi32(0xFF)), 16);
+			const __m128i G = _mm_and_si128(Pixels, _mm_set1_epi32(0xFF00));
+
+			_mm_storeu_si128(Out++, _mm_or_si128(_mm_or_si128(R, G), Alpha));
+		}
+	}
+
+	return i;
+}
+
+static int64 SSE2RGBA8ToBGRA8(const uint8* Source, uint8* Dest, const int64 Num) {
+	const __m128i GA = _mm_set1_epi32(static_cast<int32>(0xFF00FF00));
+	const __m128i Low = _mm_set1_epi32(0xFF);
+
+	int64 i = 0;
+	for (; i + 4 <= Num; i += 4) {
+		const __m128i Pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Source + i * 4));
+
+		// Red and blue trade places, green and alpha stay
+		const __m128i R = _mm_slli_epi32(_mm_and_si128(Pixels, Low), 16);
+		const __m128i B = _mm_and_si128(_mm_srli_epi32(Pixels, 16), Low);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(Dest + i * 4), _mm_or_si128(_mm_and_si128(Pixels, GA), _mm_or_si128(R, B)));
+	}
+
+	return i;
+}
+
+static int64 SSE2R16FToRGBA16F(const uint8* Source, uint8* Dest, const int64 Num) {
+	const __m128i Alpha = _mm_set1_epi64x(static_cast<int64>(HalfOne) << 48);
+	const __m128i RGB = _mm_set1_epi64x(0x0000FFFFFFFFFFFF);
+
+	int64 i = 0;
+	for (; i + 4 <= Num; i += 4) {
+		const __m128i R = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(Source + i * 2));
+		const __m128i RR = _mm_unpacklo_epi16(R, R);
+
+		__m128i* Out = reinterpret_cast<__m128i*>(Dest + i * 8);
+		_mm_storeu_si128(Out, _mm_or_si128(_mm_and_si128(_mm_unpacklo_epi32(RR, RR), RGB), Alpha));
+		_mm_storeu_si128(Out + 1, _mm_or_si128(_mm_and_si128(_mm_unpackhi_epi32(RR, RR), RGB), Alpha));
+	}
+
+	return i;
+}
+
+static int64 SSE2RG16FToRGBA16F(const uint8* Source, uint8* Dest, const int64 Num) {
+	const __m128i BA = _mm_set1_epi32(static_cast<int32>(HalfOne) << 16);
+
+	int64 i = 0;
+	for (; i + 4 <= Num; i += 4) {
+		const __m128i RG = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Source + i * 4));
+
+		__m128i* Out = reinterpret_cast<__m128i*>(Dest + i * 8);
+		_mm_storeu_si128(Out, _mm_unpacklo_epi32(RG, BA));
+		_mm_storeu_si128(Out + 1, _mm_unpackhi_epi32(RG, BA));
+	}
+
+	return i;
+}
+
+/*
+* AVX2 kernels, only called when the CPU (and OS) support it. The source is widened with
+* zero-extension so nothing crosses the 128-bit lanes.
+*/
+SWIZZLE_TARGET_AVX2 static int64 AVX2G8ToBGRA8(const uint8* Source, uint8* Dest, const int64 Num) {
+	const __m256i Alpha = _mm256_set1_epi32(static_cast<int32>(0xFF000000));
+
+	int64 i = 0;
+	for (; i + 8 <= Num; i += 8) {
+		const __m256i G = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(Source + i)));
+		const __m256i GGG = _mm256_or_si256(G, _mm256_or_si256(_mm256_slli_epi32(G, 8), _mm256_slli_epi32(G, 16)));
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Dest + i * 4), _mm256_or_si256(GGG, Alpha));
+	}
+
+	return i;
+}
+
+SWIZZLE_TARGET_AVX2 static int64 AVX2R8G8ToBGRA8(const uint8* Source, uint8* Dest, const int64 Num) {
+	const __m256i Alpha = _mm256_set1_epi32(static_cast<int32>(0xFF000000));
+
+	int64 i = 0;
+	for (; i + 8 <= Num; i += 8) {
+		const __m256i Pixels = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Source + i * 2)));
+		const __m256i R = _mm256_slli_epi32(_mm256_and_si256(Pixels, _mm256_set1_epi32(0xFF)), 16);
+		const __m256i G = _mm256_and_si256(Pixels, _mm256_set1_epi32(0xFF00));
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Dest + i * 4), _mm256_or_si256(_mm256_or_si256(R, G), Alpha));
+	}
+
+	return i;
+}
+
+SWIZZLE_TARGET_AVX2 static int64 AVX2RGBA8ToBGRA8(const uint8* Source, uint8* Dest, const int64 Num) {
+	const __m256i Shuffle = _mm256_setr_epi8(
+		2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+		2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15
+	);
+
+	int64 i = 0;
+	for (; i + 8 <= Num; i += 8) {
+		const __m256i Pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Source + i * 4));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Dest + i * 4), _mm256_shuffle_epi8(Pixels, Shuffle));
+	}
+
+	return i;
+}
+
+SWIZZLE_TARGET_AVX2 static int64 AVX2R16FToRGBA16F(const uint8* Source, uint8* Dest, const int64 Num) {
+	const __m256i Alpha = _mm256_set1_epi64x(static_cast<int64>(HalfOne) << 48);
+
+	int64 i = 0;
+	for (; i + 4 <= Num; i += 4) {
+		const __m256i R = _mm256_cvtepu16_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(Source + i * 2)));
+		const __m256i RGB = _mm256_or_si256(R, _mm256_or_si256(_mm256_slli_epi64(R, 16), _mm256_slli_epi64(R, 32)));
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Dest + i * 8), _mm256_or_si256(RGB, Alpha));
+	}
+
+	return i;
+}
+
+SWIZZLE_TARGET_AVX2 static int64 AVX2RG16FToRGBA16F(const uint8* Source, uint8* Dest, const int64 Num) {
+	const __m256i Alpha = _mm256_set1_epi64x(static_cast<int64>(HalfOne) << 48);
+
+	int64 i = 0;
+	for (; i + 4 <= Num; i += 4) {
+		const __m256i RG = _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Source + i * 4)));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Dest + i * 8), _mm256_or_si256(RG, Alpha));
+	}
+
+	return i;
+}
+
+static bool DetectAVX2() {
+	uint32 Ecx1, Ebx7;
+
+#if defined(_MSC_VER)
+	int Info[4];
+	__cpuid(Info, 0);
+	if (Info[0] < 7)
+		return false;
+
+	__cpuid(Info, 1);
+	Ecx1 = static_cast<uint32>(Info[2]);
+
+	__cpuidex(Info, 7, 0);
+	Ebx7 = static_cast<uint32>(Info[1]);
+#else
+	uint32 Eax, Ebx, Edx;
+	if (!__get_cpuid(1, &Eax, &Ebx, &Ecx1, &Edx))
+		return false;
+
+	uint32 Ecx7;
+	if (!__get_cpuid_count(7, 0, &Eax, &Ebx7, &Ecx7, &Edx))
+		return false;
+#endif
+
+	// AVX and OSXSAVE, AVX2, and the OS saving the YMM registers
+	const uint32 Required = (1u << 28) | (1u << 27);
+	if ((Ecx1 & Required) != Required || (Ebx7 & (1u << 5)) == 0)
+		return false;
+
+#if defined(_MSC_VER)
+	const uint64 Xcr0 = _xgetbv(0);
+#else
+	uint32 Xcr0Low, Xcr0High;
+	__asm__ ("xgetbv" : "=a" (Xcr0Low), "=d" (Xcr0High) : "c" (0));
+	const uint64 Xcr0 = Xcr0Low | (static_cast<uint64>(Xcr0High) << 32);
+#endif
+
+	return (Xcr0 & 6) == 6;
+}
+
+#endif
+
+using FVectorKernel = int64 (*)(const uint8* Source, uint8* Dest, int64 Num);
+using FScalarKernel = void (*)(const uint8* Source, uint8* Dest, int64 Num);
+
+struct FSwizzleKernels {
+	FVectorKernel Vector[static_cast<int32>(ESwizzleKernel::Count)] = {};
+	FScalarKernel Scalar[static_cast<int32>(ESwizzleKernel::Count)] = {};
+
+	const TCHAR* Name = TEXT("scalar");
+};
+
+static FSwizzleKernels ResolveKernels() {
+	FSwizzleKernels Kernels;
+
+	auto Set = [&Kernels](ESwizzleKernel Kernel, const FScalarKernel Scalar, const FVectorKernel Vector) {
+		Kernels.Scalar[static_cast<int32>(Kernel)] = Scalar;
+		Kernels.Vector[static_cast<int32>(Kernel)] = Vector;
+	};
+
+#if PLATFORM_CPU_X86_FAMILY
+	if (DetectAVX2()) {
+		Kernels.Name = TEXT("AVX2");
+
+		Set(ESwizzleKernel::G8ToBGRA8, ScalarG8ToBGRA8, AVX2G8ToBGRA8);
+		Set(ESwizzleKernel::R8G8ToBGRA8, ScalarR8G8ToBGRA8, AVX2R8G8ToBGRA8);
+		Set(ESwizzleKernel::RGBA8ToBGRA8, ScalarRGBA8ToBGRA8, AVX2RGBA8ToBGRA8);
+		Set(ESwizzleKernel::R16FToRGBA16F, ScalarR16FToRGBA16F, AVX2R16FToRGBA16F);
+		Set(ESwizzleKernel::RG16FToRGBA16F, ScalarRG16FToRGBA16F, AVX2RG16FToRGBA16F);
+	} else {
+		Kernels.Name = TEXT("SSE2");
+
+		Set(ESwizzleKernel::G8ToBGRA8, ScalarG8ToBGRA8, SSE2G8ToBGRA8);
+		Set(ESwizzleKernel::R8G8ToBGRA8, ScalarR8G8ToBGRA8, SSE2R8G8ToBGRA8);
+		Set(ESwizzleKernel::RGBA8ToBGRA8, ScalarRGBA8ToBGRA8, SSE2RGBA8ToBGRA8);
+		Set(ESwizzleKernel::R16FToRGBA16F, ScalarR16FToRGBA16F, SSE2R16FToRGBA16F);
+		Set(ESwizzleKernel::RG16FToRGBA16F, ScalarRG16FToRGBA16F, SSE2RG16FToRGBA16F);
+	}
+#else
+	Set(ESwizzleKernel::G8ToBGRA8, ScalarG8ToBGRA8, nullptr);
+	Set(ESwizzleKernel::R8G8ToBGRA8, ScalarR8G8ToBGRA8, nullptr);
+	Set(ESwizzleKernel::RGBA8ToBGRA8, ScalarRGBA8ToBGRA8, nullptr);
+	Set(ESwizzleKernel::R16FToRGBA16F, ScalarR16FToRGBA16F, nullptr);
+	Set(ESwizzleKernel::RG16FToRGBA16F, ScalarRG16FToRGBA16F, nullptr);
+#endif
+
+	return Kernels;
+}
+
+static const FSwizzleKernels& GetKernels() {
+	// Resolved once, thread-safe (function-local static)
+	static const FSwizzleKernels Kernels = ResolveKernels();
+	return Kernels;
+}
+
+bool GetUncompressedSourceFormat(const EPixelFormat Format, ETextureSourceFormat& OutFormat) {
+	const FUncompressedFormat* Entry = FindUncompressedFormat(Format);
+	if (Entry == nullptr)
+		return false;
+
+	OutFormat = Entry->SourceFormat;
+	return true;
+}
+
+bool ConvertUncompressed(const uint8* Data, uint8* OutData, const int64 NumPixels, const EPixelFormat Format) {
+	const FUncompressedFormat* Entry = FindUncompressedFormat(Format);
+	if (Entry == nullptr)
+		return false;
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	const FSwizzleKernels& Kernels = GetKernels();
+	const FVectorKernel Vector = Kernels.Vector[static_cast<int32>(Entry->Kernel)];
+	const FScalarKernel Scalar = Kernels.Scalar[static_cast<int32>(Entry->Kernel)];
+
+	const int32 NumChunks = static_cast<int32>(FMath::DivideAndRoundUp(NumPixels, PixelsPerChunk));
+
+	ParallelFor(NumChunks, [&](const int32 Chunk) {
+		const int64 First = Chunk * PixelsPerChunk;
+		const int64 Count = FMath::Min(PixelsPerChunk, NumPixels - First);
+
+		const uint8* Source = Data + First * Entry->SourceBytes;
+		uint8* Dest = OutData + First * Entry->DestBytes;
+
+		if (Entry->Kernel == ESwizzleKernel::Copy) {
+			FMemory::Memcpy(Dest, Source, Count * Entry->DestBytes);
+			return;
+		}
+
+		const int64 Done = Vector ? Vector(Source, Dest, Count) : 0;
+		Scalar(Source + Done * Entry->SourceBytes, Dest + Done * Entry->DestBytes, Count - Done);
+	});
+
+	const double Seconds = FPlatformTime::Seconds() - StartTime;
+	UE_LOG(LogJson, Log, TEXT("Converted %lld %s pixels in %.2f ms (%.1f MPixels/s, %s, %d chunks)"),
+		NumPixels, GetPixelFormatString(Format), Seconds * 1000.0,
+		static_cast<double>(NumPixels) / FMath::Max(Seconds, 1e-6) / 1e6, Kernels.Name, NumChunks
+	);
+
+	return true;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "Engine/Texture.h"
+
+/*
+* Uncompressed pixel formats, expanded or swizzled into the source format they're imported as:
+* gray and red/green to BGRA8 (same layout as our BC4 / BC5 imports), 16-bit float channels to
+* RGBA16F, and formats already matching one are copied.
+*
+* Pixels are split in chunks converted in parallel on the task graph. The kernels are picked
+* once at run-time, AVX2 when the CPU has it, SSE2 otherwise (scalar off x86).
+*/
+
+// Source format an uncompressed pixel format is imported as, false if it isn't one we support
+bool GetUncompressedSourceFormat(EPixelFormat Format, ETextureSourceFormat& OutFormat);
+
+// Converts NumPixels of Format into its source format, false if it isn't one we support
+bool ConvertUncompressed(const uint8* Data, uint8* OutData, int64 NumPixels, EPixelFormat Format);
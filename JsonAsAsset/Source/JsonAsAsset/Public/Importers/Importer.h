@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "Dom/JsonObject.h"
 #include "Utilities/ObjectUtilities.h"
 #include "Utilities/PropertyUtilities.h"
@@ -14,6 +16,7 @@ public:
 	              PropertySerializer(nullptr),
 	              Package(nullptr),
 	              OutermostPkg(nullptr) {
+		NumLiveImporters++;
 	}
 
 	IImporter(const FString& FileName, const FString& FilePath, const TSharedPtr<FJsonObject>& JsonObject, UPackage* Package, UPackage* OutermostPkg, const TArray<TSharedPtr<FJsonValue>>& AllJsonObjects = {}) {
@@ -26,11 +29,27 @@ public:
 		this->PropertySerializer = NewObject<UPropertySerializer>();
 		this->GObjectSerializer = NewObject<UObjectSerializer>();
 		this->GObjectSerializer->SetPropertySerializer(PropertySerializer);
+
+		// Not referenced by any UObject, only keep them alive while this importer is
+		this->PropertySerializer->AddToRoot();
+		this->GObjectSerializer->AddToRoot();
+
+		NumLiveImporters++;
 	}
 
 	virtual ~IImporter() {
+		if (PropertySerializer != nullptr) PropertySerializer->RemoveFromRoot();
+		if (GObjectSerializer != nullptr) GObjectSerializer->RemoveFromRoot();
+
+		NumLiveImporters--;
 	}
 
+	IImporter(const IImporter&) = delete;
+	IImporter& operator=(const IImporter&) = delete;
+
+	// Importers that haven't been destroyed yet, used by the batch memory report
+	static int32 GetNumLiveImporters() { return NumLiveImporters.load(); }
+
 	// Import the data of the supported type, return if successful or not
 	virtual bool ImportData() { return false; }
 
@@ -41,6 +60,9 @@ private:
 	UPROPERTY()
 	UObjectSerializer* GObjectSerializer;
 
+	// Every importer is released before the game thread call that created it returns, atomic so it can be read from anywhere
+	inline static std::atomic<int32> NumLiveImporters{0};
+
 	inline static TArray<FString> AcceptedTypes = {
 		"CurveTable",
 		"CurveFloat",
@@ -85,6 +107,10 @@ private:
 
 		// separator
 
+		"Texture2D",
+		"TextureCube",
+		"VolumeTexture",
+		"Texture2DArray",
 		"TextureRenderTarget2D",
 		"PhysicalMaterial"
 	};
@@ -115,6 +141,12 @@ public:
 	void ImportReference(const FString& File);
 	bool HandleReference(const FString& GamePath);
 
+	// Path to the exported JSON of a reference, relative to the file being imported
+	static FString GetReferenceFile(const FString& File, const FString& GamePath);
+
+	// Starts background fetches for every ObjectPath in the exports that isn't loaded yet
+	void PrefetchReferences(const TArray<TSharedPtr<FJsonValue>>& Exports, const FString& File);
+
 	bool HandleExports(TArray<TSharedPtr<FJsonValue>> Exports, FString File, bool bHideNotifications = false);
 
 	/*
@@ -134,7 +166,11 @@ public:
 
 protected:
 	bool HandleAssetCreation(UObject* Asset) const;
-	void SavePackage();
+	// False if the package wasn't saved (saving disabled, or failed)
+	bool SavePackage();
+
+	// Saves an imported export, and commits it to the batch's journal once it's on disk
+	bool CommitImport(const FString& File, const FString& Name, const FString& Type);
 
 	// Wrapper for remote downloading
 	template <class T = UObject>
@@ -3,6 +3,31 @@
 #pragma once
 
 #include "Importer.h"
+#include "Engine/Texture.h"
+
+class UTexture2D;
+class UTextureCube;
+class UTexture2DArray;
+class UVolumeTexture;
+
+// Source data of a texture, decoded off the game thread
+struct FTextureDecodeJob {
+	int SizeX = 0;
+	int SizeY = 0;
+
+	// Slices of the source (cube faces, array layers or volume depth), 0 to count them from the data
+	int32 NumSlices = 1;
+
+	EPixelFormat PixelFormat = PF_Unknown;
+	ETextureSourceFormat Format = TSF_BGRA8;
+
+	// First mip of the texture's source, locked while the job decodes into it
+	uint8* MipData = nullptr;
+	int64 MipSize = 0;
+
+	// Set once the whole mip was decoded, the mip is zeroed (and the import fails) otherwise
+	bool bDecoded = false;
+};
 
 class UTextureImporter : public IImporter {
 public:
@@ -10,15 +35,63 @@ public:
 		IImporter(FileName, FilePath, JsonObject, Package, OutermostPkg) {
 	}
 
-	// Public as we don't import 2D textures locally at the moment
+	// Imports from the image FModel saved next to the JSON (.dds or .png), without Local Fetch
+	virtual bool ImportData() override;
+
+	// Imports from the platform data of the first mip
 	bool ImportTexture2D(UTexture*& OutTexture2D, TArray<uint8>& Data, const TSharedPtr<FJsonObject>& Properties) const;
 	bool ImportTextureCube(UTexture*& OutTextureCube, TArray<uint8>& Data, const TSharedPtr<FJsonObject>& Properties) const;
-	bool ImportVolumeTexture(UTexture*& OutTexture2D, const TArray<uint8>& Data, const TSharedPtr<FJsonObject>& Properties) const;
+	bool ImportVolumeTexture(UTexture*& OutVolumeTexture, const TArray<uint8>& Data, const TSharedPtr<FJsonObject>& Properties) const;
+	bool ImportTexture2DArray(UTexture*& OutTexture2DArray, const TArray<uint8>& Data, const TSharedPtr<FJsonObject>& Properties) const;
 	bool ImportRenderTarget2D(UTexture*& OutRenderTarget2D, const TSharedPtr<FJsonObject>& Properties) const;
 
 	bool ImportTexture2D_Data(UTexture2D* InTexture2D, const TSharedPtr<FJsonObject>& Properties) const;
 	bool ImportTexture_Data(UTexture* InTexture, const TSharedPtr<FJsonObject>& Properties) const;
 
+	/*
+	* Split import, used to decode on worker threads:
+	*  Create[...]     (game thread) creates the texture, and describes its source in the job
+	*  BeginDecode     (game thread) allocates the texture's source, and locks its first mip
+	*  DecodeTexture   (any thread)  decodes the platform data stripe by stripe, straight into the locked mip
+	*                                (slices of cubes, arrays and volumes are decoded in parallel)
+	*  FinalizeTexture (game thread) unlocks the mip, and updates the texture (false if it wasn't decoded)
+	*
+	* There is no full-size intermediate buffer, even 16K sources only ever take their own size
+	* (plus a few stripes while decoding).
+	*/
+	UTexture2D* CreateTexture2D(const TSharedPtr<FJsonObject>& Properties, FTextureDecodeJob& OutJob) const;
+	UTextureCube* CreateTextureCube(const TSharedPtr<FJsonObject>& Properties, FTextureDecodeJob& OutJob) const;
+	UVolumeTexture* CreateVolumeTexture(const TSharedPtr<FJsonObject>& Properties, FTextureDecodeJob& OutJob) const;
+	UTexture2DArray* CreateTexture2DArray(const TSharedPtr<FJsonObject>& Properties, FTextureDecodeJob& OutJob) const;
+
+	// DataSize is the size of the platform data, used when the number of slices isn't known
+	static void BeginDecode(UTexture* Texture, FTextureDecodeJob& Job, int64 DataSize);
+	static bool DecodeTexture(FTextureDecodeJob& Job, const TArray<uint8>& Data);
+	static bool FinalizeTexture(UTexture* Texture, const FTextureDecodeJob& Job);
+
 private:
-	void GetDecompressedTextureData(uint8* Data, uint8*& OutData, const int SizeX, const int SizeY, const int TotalSize, const EPixelFormat Format) const;
+	// Decoded to TSF_RGBA16F whatever the compression settings are (BC6H, 32-bit float RGBA)
+	static bool IsHalfFloatDecoded(const EPixelFormat Format) { return Format == PF_BC6H || Format == PF_A32B32G32R32F; }
+
+	// Source format the platform data is decoded into
+	static ETextureSourceFormat GetSourceFormat(const EPixelFormat Format);
+
+	// Image exported next to the JSON, empty if there is none
+	FString FindLocalImageFile() const;
+
+	/*
+	* Fills the source from an exported image, mapped in memory. Every mip of every slice
+	* of a DDS file is decoded in parallel (lower mips only with LeaveExistingMips).
+	*/
+	static bool ImportDDSFile(UTexture* Texture, FTextureDecodeJob& Job, const uint8* Data, int64 Size);
+	static bool ImportPNGFile(UTexture* Texture, FTextureDecodeJob& Job, const uint8* Data, int64 Size);
+
+	// Size of one slice of the platform data, 0 if the format's block size isn't known
+	static int64 GetPlatformSliceSize(const int SizeX, const int SizeY, const EPixelFormat Format);
+
+	// Decodes one slice, through the decoded texture cache (false if it couldn't be decoded)
+	static bool GetDecompressedTextureData(const uint8* Data, uint8* OutData, const int SizeX, const int SizeY, const int64 TotalSize, const EPixelFormat Format);
+
+	// Decodes one slice, false if it couldn't be decoded
+	static bool DecodePlatformData(const uint8* Data, uint8* OutData, const int SizeX, const int SizeY, const int64 TotalSize, const EPixelFormat Format);
 };
@@ -33,7 +33,10 @@ private:
 
 	// Creates a dialog for a file
 	TArray<FString> OpenFileDialog(FString Title, FString Type);
-	bool IsProcessRunning(const FString& ProcessName);
+
+	// Memory report of the toolbar batches, each is compared to the one before it
+	int32 NumBatches = 0;
+	double LastRetainedMB = 0.0;
 };
 
 // About JsonAsAsset (copied from Epic Games Source)
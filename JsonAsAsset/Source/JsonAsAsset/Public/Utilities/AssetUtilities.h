@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include "Interfaces/IHttpRequest.h"
+
 class FAssetUtilities {
 public:
 	/*
@@ -20,13 +22,53 @@ public:
 	 */
 	static UObject* GetSelectedAsset();
 
+	// Saves a package the way importers do, false if it wasn't saved (saving disabled, or failed)
+	static bool SavePackage(UPackage* Package);
+
 	// Purpose: Wrapping references before they get set
 	//          to import them
 public:
 	template <class T = UObject>
 	static bool ConstructAsset(const FString& Path, const FString& Type, TObjectPtr<T>& OutObject, bool& bSuccess);
+	static bool CanConstructAsset(const FString& Type);
 	static bool Construct_TypeTexture(const FString& Path, UTexture*& OutTexture);
 
+	/*
+	* Textures are returned before their source is downloaded and decoded. The end of an import
+	* batch waits here (ticking HTTP and game thread tasks) until every texture it started is
+	* saved or failed, commits them to the batch's journal and reports them.
+	*/
+	static void WaitForTextureImports();
+
+private:
+	// Downloads and decodes the texture's source off the game thread (from a small mip first, with proxy imports)
+	static void ImportTextureDataAsync(UTexture* Texture, const FString& Path, const TSharedRef<struct FTextureDecodeJob>& Job);
+	static void ImportProxyTextureData(UTexture* Texture, const FString& Path, const TSharedRef<struct FTextureDecodeJob>& Job, const FHttpResponsePtr& HttpResponse);
+	// bHasProxy: the texture already holds a proxy, it's kept (and saved) if the full resolution data can't be downloaded
+	static void ImportFullTextureData(UTexture* Texture, const FString& Path, const TSharedRef<struct FTextureDecodeJob>& Job, bool bHasProxy = false);
+
+	// Size of the mip the API sent (X-Mip-SizeX / X-Mip-SizeY), false if it didn't say
+	static bool GetResponseMipSize(const FHttpResponsePtr& HttpResponse, int32& OutSizeX, int32& OutSizeY);
+
+	// Decodes into the texture's source on a worker, OnDecoded is called on the game thread once it's filled in (the import fails instead if the decode did)
+	static void DecodeTextureData(UTexture* Texture, const FString& Path, const TSharedRef<struct FTextureDecodeJob>& Job, const FHttpResponsePtr& HttpResponse, TFunction<void(UTexture*)>&& OnDecoded);
+
+	// Takes the prefetched request for URL or starts a new one, OnDataDownloaded is called on the game thread
+	static void RequestTextureData(const FString& URL, TFunction<void(const FHttpResponsePtr&)>&& OnDataDownloaded);
+
+	// Saves the texture once its source is filled in (bComplete false: it only got its proxy, reported as failed)
+	static void FinishTextureImport(UTexture* Texture, const FString& Path, bool bComplete = true);
+
+	// Left unsaved, Texture is null if it was already destroyed
+	static void FailTextureImport(UTexture* Texture, const FString& Path);
+
+	// Texture imports of the current batch, still downloading or decoding
+	inline static int32 NumPendingTextureImports = 0;
+	inline static int32 NumTextureImports = 0;
+	inline static TArray<FString> FailedTextureImports;
+
+public:
+
 	static void CreatePlugin(FString PluginName);
 
 	static const TSharedPtr<FJsonObject> API_RequestExports(const FString& Path);
@@ -0,0 +1,35 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Modules/ModuleManager.h"
+
+/*
+* Resolves export types ("Material", "MaterialExpressionAdd") to their classes, once per
+* session. Every export of every import resolves its type, so results are cached, along
+* with redirected classes and types that don't exist. The cache is thread-safe, but misses
+* search the object tables and must run on the game thread.
+*/
+class FClassUtilities {
+public:
+	// Class of a type name (or a full class path), nullptr if it doesn't exist
+	static UClass* FindClass(FName Type);
+
+	// Drops types that didn't resolve whenever modules change, they may exist now
+	static void Initialize();
+	static void Shutdown();
+
+private:
+	// Search without the cache: engine classes first, then any package, then redirects
+	static UClass* ResolveClass(const FString& Type);
+
+	static void OnModulesChanged(FName ModuleName, EModuleChangeReason Reason);
+
+	static FRWLock Lock;
+
+	// Null for types that don't exist, stale if the class went away (hot reload)
+	static TMap<FName, TWeakObjectPtr<UClass>> Classes;
+
+	static FDelegateHandle ModulesChangedHandle;
+};
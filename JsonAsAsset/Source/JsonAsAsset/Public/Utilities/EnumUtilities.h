@@ -0,0 +1,29 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Class.h"
+#include "UObject/ObjectKey.h"
+
+/*
+* Resolves enum names from exports ("EFoo::Bar" or "Bar") to their values through a hashed
+* table per enum, built on first use. UEnum::GetValueByNameString compares every name of
+* the enum, and runs for every enum field and key of an import. Safe to use from any thread.
+*/
+class FEnumUtilities {
+public:
+	// Value of a name of Enum, INDEX_NONE if it isn't one (redirected names resolve too)
+	static int64 GetValue(const UEnum* Enum, const FString& Name);
+
+	template <typename TEnum>
+	static TEnum GetValue(const FString& Name) {
+		return static_cast<TEnum>(GetValue(StaticEnum<TEnum>(), Name));
+	}
+
+private:
+	static FRWLock Lock;
+
+	// Names of each enum, with and without the enum's prefix (case insensitive, like FName)
+	static TMap<TObjectKey<UEnum>, TMap<FString, int64>> Enums;
+};
@@ -0,0 +1,53 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Misc/ScopedSlowTask.h"
+
+/*
+* A batch of files imported from the toolbar.
+*
+* Shows a cancelable progress dialog, and keeps a journal of every export
+* that was committed (imported and saved). Starting the same batch again
+* resumes after the last committed export, the journal is removed once
+* the batch finishes without being canceled.
+*/
+class JSONASASSET_API FImportJob {
+public:
+	FImportJob(const TArray<FString>& InFiles);
+	~FImportJob();
+
+	// The job currently running, or nullptr
+	static FImportJob* Get() { return ActiveJob; }
+
+	const TArray<FString>& GetFiles() const { return Files; }
+
+	// Advances the progress dialog to the next file
+	void EnterFile(const FString& File);
+
+	// Polls the cancel button of the progress dialog
+	bool ShouldCancel();
+	bool WasCanceled() const { return bCanceled; }
+
+	// Committed in this batch (or a previous run of it), and still loadable
+	bool IsCommitted(const FString& File, const FString& ExportName) const;
+	void Commit(const FString& File, const FString& ExportName, const FString& PackageName);
+
+	int32 GetNumResumed() const { return NumResumed; }
+
+private:
+	static FString GetKey(const FString& File, const FString& ExportName);
+
+	static FImportJob* ActiveJob;
+
+	TArray<FString> Files;
+	FString BatchId;
+	FString JournalPath;
+
+	// Export key -> package it was saved into
+	TMap<FString, FString> Committed;
+
+	FScopedSlowTask SlowTask;
+	bool bCanceled = false;
+	int32 NumResumed = 0;
+};
@@ -0,0 +1,78 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Ticker.h"
+#include "HAL/PlatformProcess.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Interfaces/IHttpResponse.h"
+
+/*
+* Supervises the Local Fetch API process, on any platform the editor runs on.
+*
+* The service is checked over HTTP (not by looking for it in the process list),
+* so an instance that is already up (started by hand, or by a previous editor
+* session) is reused as is. An instance started here is restarted if it crashes,
+* and stays warm across imports until it is stopped.
+*
+* Readiness is polled in the background against /health, the UI and the import
+* entry points only ever read the cached state.
+*
+* Instances launched here get a per-launch token on their command line, only
+* requests carrying it can shut them down over HTTP.
+*/
+class FLocalFetchProcess {
+public:
+	// Path to the API binary for the platform the editor is running on
+	static FString GetExecutablePath();
+
+	// Reuses a healthy instance, or launches a new one once the health check fails (launch failures are logged)
+	static void Start();
+
+	// Stops the instance, whether it was launched here or not
+	static void Stop();
+
+	// Checks the API's health without blocking, OnChecked is called on the game thread with the result
+	// (never for a check that was still in flight when the instance was stopped)
+	static void CheckHealth(float Timeout, TFunction<void(bool bHealthy)>&& OnChecked);
+
+	// Last known health, from the background poll (false until the first poll is back)
+	static bool IsReady();
+
+	// Starts polling /health at a low rate
+	static void StartPolling();
+
+	// True if an instance launched here is still running (doesn't touch the network)
+	static bool IsLaunched();
+
+	// Called on module shutdown, the process is left running so it stays warm
+	static void Shutdown();
+
+private:
+	static bool Launch();
+	static bool Tick(float DeltaTime);
+	static bool Poll(float DeltaTime);
+
+	// Token of the last instance launched here, kept on disk so a later editor session can still stop it
+	static FString GetShutdownTokenPath();
+
+	// Restarts in a row before giving up on a crashing instance
+	static constexpr int32 MaxRestarts = 3;
+
+	// Running this long counts as stable, the restart count starts over
+	static constexpr double StableRunTime = 60.0;
+	static constexpr float TickInterval = 2.0f;
+	static constexpr float PollInterval = 5.0f;
+
+	static FProcHandle ProcessHandle;
+	static FTSTicker::FDelegateHandle TickerHandle;
+	static FTSTicker::FDelegateHandle PollHandle;
+	static int32 NumRestarts;
+	static double LaunchTime;
+
+	static bool bReady;
+	static bool bPollInFlight;
+
+	// Bumped whenever the cached state is dropped, health checks started before are ignored
+	static uint32 HealthGeneration;
+};
@@ -37,14 +37,24 @@ private:
         UPackage* SourcePackage;
     UPROPERTY()
         TMap<UObject*, int32> ObjectIndices;
+
+    /** Indexed by object index, entries of objects not deserialized yet are unset in bObjectsLoaded */
     UPROPERTY()
-        TMap<int32, UObject*> LoadedObjects;
+        TArray<UObject*> LoadedObjects;
+    TBitArray<> bObjectsLoaded;
+
     int32 LastObjectIndex;
     UPROPERTY()
         UPropertySerializer* PropertySerializer;
-    TMap<int32, TSharedPtr<FJsonObject>> SerializedObjects;
+
+    /** Indexed by object index */
+    TArray<TSharedPtr<FJsonObject>> SerializedObjects;
+
+    /** Object marks, looked up both ways */
     UPROPERTY()
         TMap<UObject*, FString> ObjectMarks;
+    UPROPERTY()
+        TMap<FString, UObject*> MarkedObjects;
 public:
     UObjectSerializer();
 
@@ -106,4 +116,11 @@ private:
 
     UObject* DeserializeImportedObject(TSharedPtr<FJsonObject> ObjectJson);
     UObject* DeserializeExportedObject(int32 ObjectIndex, TSharedPtr<FJsonObject> ObjectJson);
+
+    /** Null if there is no object at this index */
+    const TSharedPtr<FJsonObject>& FindSerializedObject(int32 ObjectIndex) const;
+    const TSharedPtr<FJsonObject>& GetSerializedObject(int32 ObjectIndex) const;
+
+    UObject* const* FindLoadedObject(int32 ObjectIndex) const;
+    void SetLoadedObject(int32 ObjectIndex, UObject* Object);
 };
\ No newline at end of file
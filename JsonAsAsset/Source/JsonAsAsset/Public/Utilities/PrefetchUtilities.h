@@ -0,0 +1,64 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+#include "Async/Future.h"
+#include "Dom/JsonObject.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Interfaces/IHttpResponse.h"
+
+/*
+* Fetches references (local JSON files, or Local Fetch exports) in the background
+* before an importer asks for them, so LoadObject finds the data already local.
+*
+* Everything is keyed by file path / URL, and taken (removed) once consumed.
+*/
+class FPrefetchUtilities {
+public:
+	/*
+	* Held for the length of an import batch (toolbar, drag-drop, reimport...). Once the outermost
+	* scope ends, the textures the batch started are waited on, and anything prefetched but never
+	* consumed is dropped.
+	*/
+	struct FBatchScope {
+		FBatchScope() { BatchDepth++; }
+		~FBatchScope();
+
+		FBatchScope(const FBatchScope&) = delete;
+		FBatchScope& operator=(const FBatchScope&) = delete;
+	};
+
+	// Reads and parses a local JSON file on a worker thread
+	static void PrefetchFile(const FString& File);
+
+	// Takes a prefetched file, waiting on the worker if needed (false if it was never prefetched)
+	static bool TakeFile(const FString& File, TSharedPtr<FJsonObject>& OutJsonParsed);
+
+	// Starts a Local Fetch request without waiting on it
+	static void PrefetchRequest(const FString& URL, const FString& ContentType = "");
+
+	// True if a request was prefetched for this URL and not taken yet
+	static bool HasRequest(const FString& URL);
+
+	// Takes a prefetched request as is, it may still be in flight
+	static TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> TakeRequest(const FString& URL);
+
+	// Takes the response of a prefetched request, waiting on it if it's still in flight
+	static TSharedPtr<IHttpResponse, ESPMode::ThreadSafe> TakeResponse(const FString& URL);
+
+	// Drops anything that was never consumed
+	static void Reset();
+
+	// Reads a exported JSON file, wrapped as { "data": [...] }
+	static TSharedPtr<FJsonObject> LoadReferenceFile(const FString& File);
+
+private:
+	// Requests in flight at once, the rest are fetched on demand
+	static constexpr int32 MaxRequestsInFlight = 32;
+
+	// Nested import batches, only touched on the game thread
+	inline static int32 BatchDepth = 0;
+
+	static FCriticalSection Lock;
+	static TMap<FString, TSharedFuture<TSharedPtr<FJsonObject>>> Files;
+	static TMap<FString, TSharedRef<IHttpRequest, ESPMode::ThreadSafe>> Requests;
+};
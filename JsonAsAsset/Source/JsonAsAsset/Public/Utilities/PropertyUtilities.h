@@ -41,6 +41,58 @@ public:
     virtual bool Compare(UScriptStruct* Struct, const TSharedPtr<FJsonObject> JsonValue, const void* StructData, const TSharedPtr<FObjectCompareContext> Context) override;
 };
 
+/** Member of a struct handled by FNativeStructSerializer, at a fixed offset */
+struct FNativeStructField {
+    enum class EType : uint8 { Float, Double, Byte, UInt32 };
+
+    const TCHAR* Name;
+    int32 Offset;
+    EType Type;
+
+    /** Set for bytes holding an enum, written as its names */
+    const UEnum* Enum = nullptr;
+};
+
+/**
+ * Serializer for structs made of plain numbers (math types, FGuid, FRichCurveKey).
+ * Fields are read and written straight in the struct's memory, without reflection.
+ * Like the fallback, fields missing from the json are left as they are.
+ */
+class FNativeStructSerializer : public FStructSerializer {
+    TArray<FNativeStructField> Fields;
+public:
+    FNativeStructSerializer(const TArray<FNativeStructField>& Fields);
+
+    void SerializeFields(FJsonObject& JsonValue, const void* StructData) const;
+    void DeserializeFields(void* StructData, const FJsonObject& JsonValue) const;
+    bool CompareFields(const FJsonObject& JsonValue, const void* StructData) const;
+
+    virtual void Serialize(UScriptStruct* Struct, const TSharedPtr<FJsonObject> JsonValue, const void* StructData, TArray<int32>* OutReferencedSubobjects) override;
+    virtual void Deserialize(UScriptStruct* Struct, void* StructData, const TSharedPtr<FJsonObject> JsonValue) override;
+    virtual bool Compare(UScriptStruct* Struct, const TSharedPtr<FJsonObject> JsonValue, const void* StructData, const TSharedPtr<FObjectCompareContext> Context) override;
+private:
+    const FNativeStructField* FindField(const FString& Name) const;
+};
+
+/** FTransform keeps its members private, they go through its getters and setters */
+class FTransformSerializer : public FStructSerializer {
+    FNativeStructSerializer QuatSerializer;
+    FNativeStructSerializer VectorSerializer;
+public:
+    FTransformSerializer(const FNativeStructSerializer& QuatSerializer, const FNativeStructSerializer& VectorSerializer);
+
+    virtual void Serialize(UScriptStruct* Struct, const TSharedPtr<FJsonObject> JsonValue, const void* StructData, TArray<int32>* OutReferencedSubobjects) override;
+    virtual void Deserialize(UScriptStruct* Struct, void* StructData, const TSharedPtr<FJsonObject> JsonValue) override;
+    virtual bool Compare(UScriptStruct* Struct, const TSharedPtr<FJsonObject> JsonValue, const void* StructData, const TSharedPtr<FObjectCompareContext> Context) override;
+};
+
+/** Object reference left unresolved by UPropertySerializer::DeserializeStructDeferred */
+struct FPropertyFixup {
+    FProperty* Property;
+    TSharedPtr<FJsonValue> JsonValue;
+    void* Value;
+};
+
 UCLASS()
 class JSONASASSET_API UPropertySerializer : public UObject {
     GENERATED_BODY()
@@ -72,6 +124,17 @@ public:
     void DeserializePropertyValue(FProperty* Property, const TSharedRef<FJsonValue>& Value, void* OutValue);
     void DeserializeStruct(UScriptStruct* Struct, const TSharedRef<FJsonObject>& Value, void* OutValue);
 
+    /**
+     * Same as DeserializeStruct, but safe to call off the game thread: object references are
+     * recorded into OutFixups instead of being loaded, ResolveFixups sets them on the game thread.
+     * Only for structs passing CanDeserializeStructDeferred, fixups point into the struct's memory.
+     */
+    void DeserializeStructDeferred(UScriptStruct* Struct, const TSharedRef<FJsonObject>& Value, void* OutValue, TArray<FPropertyFixup>& OutFixups);
+    void ResolveFixups(const TArray<FPropertyFixup>& Fixups);
+
+    /** False if object references of the struct can't be deferred (set elements, map entries) */
+    static bool CanDeserializeStructDeferred(const UStruct* Struct);
+
     bool ComparePropertyValues(FProperty* Property, const TSharedRef<FJsonValue>& JsonValue, const void* CurrentValue, const TSharedPtr<FObjectCompareContext> Context = MakeShareable(new FObjectCompareContext));
     bool CompareStructs(UScriptStruct* Struct, const TSharedRef<FJsonObject>& JsonValue, const void* CurrentValue, const TSharedPtr<FObjectCompareContext> Context = MakeShareable(new FObjectCompareContext));
 private:
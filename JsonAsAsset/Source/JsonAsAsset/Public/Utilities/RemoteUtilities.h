@@ -7,4 +7,7 @@
 class FRemoteUtilities {
 public:
 	static TSharedPtr<IHttpResponse, ESPMode::ThreadSafe> ExecuteRequestSync(TSharedRef<IHttpRequest> HttpRequest, float LoopDelay = 0.1);
+
+	// Blocks on a request that was already started
+	static TSharedPtr<IHttpResponse, ESPMode::ThreadSafe> WaitForRequest(TSharedRef<IHttpRequest> HttpRequest, float LoopDelay = 0.1);
 };
@@ -0,0 +1,33 @@
+// This code is in the public domain -- castanyo@yahoo.es
+
+#include <nvcore/Memory.h>
+
+using namespace nv;
+
+static mem::AllocFunc s_allocFunc = NULL;
+static void * s_allocUserData = NULL;
+
+void mem::setAllocator(AllocFunc func, void * userData)
+{
+	s_allocFunc = func;
+	s_allocUserData = func != NULL ? userData : NULL;
+}
+
+void * mem::malloc(size_t size)
+{
+	if (s_allocFunc != NULL) return s_allocFunc(NULL, size, s_allocUserData);
+	return FMemory::Malloc(size);
+}
+
+void mem::free(void * ptr)
+{
+	if (ptr == NULL) return;
+	if (s_allocFunc != NULL) s_allocFunc(ptr, 0, s_allocUserData);
+	else FMemory::Free(ptr);
+}
+
+void * mem::realloc(void * ptr, size_t size)
+{
+	if (s_allocFunc != NULL) return s_allocFunc(ptr, size, s_allocUserData);
+	return FMemory::Realloc(ptr, size);
+}
@@ -21,11 +21,18 @@ namespace nv
 {
 	namespace mem
 	{
-		inline NVCORE_API void * malloc(size_t size) {return FMemory::Malloc(size);}
+		/// Allocator hook, realloc style: a NULL ptr allocates, a 0 size frees.
+		typedef void * (*AllocFunc)(void * ptr, size_t size, void * userData);
+
+		/// Routes every NVTT allocation (images, containers) to func, NULL restores FMemory.
+		/// Not thread-safe, set it before decoding anything.
+		NVTT_API void setAllocator(AllocFunc func, void * userData);
+
+		NVTT_API void * malloc(size_t size);
 		// inline NVCORE_API void * malloc(size_t size, const char * file, int line);
 
-		inline NVCORE_API void free(void* ptr) {return FMemory::Free(ptr);}
-		inline NVCORE_API void * realloc(void * ptr, size_t size) {return FMemory::Realloc(ptr, size);}
+		NVTT_API void free(void* ptr);
+		NVTT_API void * realloc(void * ptr, size_t size);
 
 	} // mem namespace
 
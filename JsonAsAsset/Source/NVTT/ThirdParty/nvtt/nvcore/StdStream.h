@@ -252,6 +252,19 @@ public:
 		{
 			return false;
 		}
+
+		/// Zero-copy read.
+		virtual const uint8 * map( uint len )
+		{
+			nvDebugCheck(!isError());
+
+			if (len > m_size - tell()) return NULL;
+
+			const uint8 * ptr = m_ptr;
+			m_ptr += len;
+
+			return ptr;
+		}
 	//@}
 
 
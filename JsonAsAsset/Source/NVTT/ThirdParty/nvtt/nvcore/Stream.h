@@ -71,6 +71,10 @@ public:
 	/// Return true if this is an output stream.
 	virtual bool isSaving() const = 0;
 
+	/// Return a pointer to the next len bytes and move past them, NULL if the
+	/// stream isn't backed by memory. Lets readers decode data in place.
+	virtual const uint8 * map( uint len ) { return NULL; }
+
 	
 	// friends	
 	friend Stream & operator<<( Stream & s, bool & c ) {
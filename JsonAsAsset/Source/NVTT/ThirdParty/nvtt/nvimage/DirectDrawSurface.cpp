@@ -659,7 +659,7 @@ bool DDSHeader::hasDX10Header() const
 	//return this->pf.flags == 0;             // @@ This is according to MS
 }
 
-DirectDrawSurface::DirectDrawSurface(const char * name) : stream(new StdInputStream(name))
+DirectDrawSurface::DirectDrawSurface(const char * name) : stream(new StdInputStream(name)), hasFileHeader(true)
 {
 	if (!stream->isError())
 	{
@@ -667,7 +667,7 @@ DirectDrawSurface::DirectDrawSurface(const char * name) : stream(new StdInputStr
 	}
 }
 
-DirectDrawSurface::DirectDrawSurface(Stream * str) : stream(str)
+DirectDrawSurface::DirectDrawSurface(Stream * str) : stream(str), hasFileHeader(true)
 {
 	if (!stream->isError())
 	{
@@ -675,6 +675,10 @@ DirectDrawSurface::DirectDrawSurface(Stream * str) : stream(str)
 	}
 }
 
+DirectDrawSurface::DirectDrawSurface(const DDSHeader & hdr, Stream * str) : stream(str), hasFileHeader(false), header(hdr)
+{
+}
+
 DirectDrawSurface::~DirectDrawSurface()
 {
 	delete stream;
@@ -896,13 +900,24 @@ void DirectDrawSurface::readLinearImage(Image * img)
 		img->setFormat(Image::Format_ARGB);
 	}
 
+	// Read in place when the stream is in memory.
+	const uint8 * pixels = stream->map(w * h * byteCount);
+
 	// Read linear RGB images.
 	for (uint y = 0; y < h; y++)
 	{
 		for (uint x = 0; x < w; x++)
 		{
 			uint c = 0;
-			stream->serialize(&c, byteCount);
+			if (pixels != NULL)
+			{
+				memcpy(&c, pixels, byteCount);
+				pixels += byteCount;
+			}
+			else
+			{
+				stream->serialize(&c, byteCount);
+			}
 
 			Color32 pixel(0, 0, 0, 0xFF);
 			pixel.r = PixelFormat::convert((c & header.pf.rmask) >> rshift, rsize, 8);
@@ -939,6 +954,10 @@ void DirectDrawSurface::readBlockImage(Image * img)
 	const uint bw = (w + 3) / 4;
 	const uint bh = (h + 3) / 4;
 
+	// Decode blocks in place when the stream is in memory, and in our byte order.
+	const uint bs = blockSize();
+	const uint8 * blocks = stream->byteOrder() == Stream::getSystemByteOrder() ? stream->map(bw * bh * bs) : NULL;
+
 	for (uint by = 0; by < bh; by++)
 	{
 		for (uint bx = 0; bx < bw; bx++)
@@ -946,7 +965,15 @@ void DirectDrawSurface::readBlockImage(Image * img)
 			ColorBlock block;
 
 			// Read color block.
-			readBlock(&block);
+			if (blocks != NULL)
+			{
+				decodeBlock(&block, blocks);
+				blocks += bs;
+			}
+			else
+			{
+				readBlock(&block);
+			}
 
 			// Write color block.
 			for (uint y = 0; y < min(4U, h-4*by); y++)
@@ -997,18 +1024,6 @@ void DirectDrawSurface::readBlock(ColorBlock * rgba)
 		BlockDXT5 block;
 		*stream << block;
 		block.decodeBlock(rgba);
-
-		if (header.pf.fourcc == FOURCC_RXGB)
-		{
-			// Swap R & A.
-			for (int i = 0; i < 16; i++)
-			{
-				Color32 & c = rgba->color(i);
-				uint tmp = c.r;
-				c.r = c.a;
-				c.a = tmp;
-			}
-		}
 	}
 	else if (header.pf.fourcc == FOURCC_ATI1)
 	{
@@ -1023,6 +1038,67 @@ void DirectDrawSurface::readBlock(ColorBlock * rgba)
 		block.decodeBlock(rgba);
 	}
 
+	convertBlock(rgba);
+}
+
+// Same as readBlock, from a block in memory. Blocks are copied to the stack, which the
+// compiler turns into plain loads (the data may not be aligned for the block types).
+void DirectDrawSurface::decodeBlock(ColorBlock * rgba, const uint8 * data) const
+{
+	nvDebugCheck(data != NULL);
+	nvDebugCheck(rgba != NULL);
+
+	if (header.pf.fourcc == FOURCC_DXT1)
+	{
+		BlockDXT1 block;
+		memcpy(&block, data, sizeof(block));
+		block.decodeBlock(rgba);
+	}
+	else if (header.pf.fourcc == FOURCC_DXT2 ||
+	    header.pf.fourcc == FOURCC_DXT3)
+	{
+		BlockDXT3 block;
+		memcpy(&block, data, sizeof(block));
+		block.decodeBlock(rgba);
+	}
+	else if (header.pf.fourcc == FOURCC_DXT4 ||
+	    header.pf.fourcc == FOURCC_DXT5 ||
+	    header.pf.fourcc == FOURCC_RXGB)
+	{
+		BlockDXT5 block;
+		memcpy(&block, data, sizeof(block));
+		block.decodeBlock(rgba);
+	}
+	else if (header.pf.fourcc == FOURCC_ATI1)
+	{
+		BlockATI1 block;
+		memcpy(&block, data, sizeof(block));
+		block.decodeBlock(rgba);
+	}
+	else if (header.pf.fourcc == FOURCC_ATI2)
+	{
+		BlockATI2 block;
+		memcpy(&block, data, sizeof(block));
+		block.decodeBlock(rgba);
+	}
+
+	convertBlock(rgba);
+}
+
+void DirectDrawSurface::convertBlock(ColorBlock * rgba) const
+{
+	if (header.pf.fourcc == FOURCC_RXGB)
+	{
+		// Swap R & A.
+		for (int i = 0; i < 16; i++)
+		{
+			Color32 & c = rgba->color(i);
+			uint tmp = c.r;
+			c.r = c.a;
+			c.a = tmp;
+		}
+	}
+
 	// If normal flag set, convert to normal.
 	if (header.pf.flags & DDPF_NORMAL)
 	{
@@ -1115,11 +1191,16 @@ uint DirectDrawSurface::faceSize() const
 
 uint DirectDrawSurface::offset(const uint face, const uint mipmap)
 {
-	uint size = 128; // sizeof(DDSHeader);
+	uint size = 0;
 
-	if (header.hasDX10Header())
+	if (hasFileHeader)
 	{
-		size += 20; // sizeof(DDSHeader10);
+		size += 128; // sizeof(DDSHeader);
+
+		if (header.hasDX10Header())
+		{
+			size += 20; // sizeof(DDSHeader10);
+		}
 	}
 
 	if (face != 0)
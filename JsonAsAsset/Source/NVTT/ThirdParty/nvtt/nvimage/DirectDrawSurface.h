@@ -199,6 +199,7 @@ namespace nv {
 	public:
 		NVTT_API DirectDrawSurface(const char* file);
 		NVTT_API DirectDrawSurface(Stream* stream); // added implicit stream version, like in recent NVTT code
+		NVTT_API DirectDrawSurface(const DDSHeader& header, Stream* stream); // surfaces only, no file header in the stream
 		NVTT_API ~DirectDrawSurface();
 
 		bool isValid() const;
@@ -230,9 +231,12 @@ namespace nv {
 		void readLinearImage(Image* img);
 		void readBlockImage(Image* img);
 		void readBlock(ColorBlock* rgba);
+		void decodeBlock(ColorBlock* rgba, const uint8* data) const;
+		void convertBlock(ColorBlock* rgba) const;
 
 	private:
 		Stream* const stream;
+		const bool hasFileHeader;
 		DDSHeader10 header10;
 
 	public:
@@ -2,6 +2,7 @@
 
 #include <nvimage/Image.h>
 #include <nvcore/Debug.h>
+#include <nvcore/Memory.h>
 #include <nvcore/Ptr.h>
 
 #include <nvmath/Color.h>
@@ -10,11 +11,11 @@ using namespace nv;
 
 static_assert(sizeof(Color32) == Image::Color32_Size, "Wrong Color32 size!");
 
-Image::Image() : m_width(0), m_height(0), m_format(Format_RGB), m_data(NULL)
+Image::Image() : m_width(0), m_height(0), m_format(Format_RGB), m_data(NULL), m_wrapped(false)
 {
 }
 
-Image::Image(const Image & img) : m_data(NULL)
+Image::Image(const Image & img) : m_data(NULL), m_wrapped(false)
 {
 	allocate(img.m_width, img.m_height);
 	m_format = img.m_format;
@@ -37,9 +38,22 @@ const Image & Image::operator=(const Image & img)
 
 void Image::allocate(uint w, uint h)
 {
+	// Wrapped memory is reused as long as it's large enough
+	if (m_wrapped)
+	{
+		if (w * h <= m_width * m_height)
+		{
+			m_width = w;
+			m_height = h;
+			return;
+		}
+
+		unwrap();
+	}
+
 	m_width = w;
 	m_height = h;
-	m_data = (Color32 *)realloc(m_data, w * h * sizeof(Color32));
+	m_data = (Color32 *)mem::realloc(m_data, w * h * sizeof(Color32));
 }
 
 // bool Image::load(const char * name)
@@ -65,6 +79,7 @@ void Image::wrap(void * data, uint w, uint h)
 	m_data = (Color32 *)data;
 	m_width = w;
 	m_height = h;
+	m_wrapped = true;
 }
 
 void Image::unwrap()
@@ -72,13 +87,19 @@ void Image::unwrap()
 	m_data = NULL;
 	m_width = 0;
 	m_height = 0;
+	m_wrapped = false;
 }
 
 
 void Image::free()
 {
-	::free(m_data);
+	if (!m_wrapped)
+	{
+		mem::free(m_data);
+	}
+
 	m_data = NULL;
+	m_wrapped = false;
 }
 
 
@@ -33,8 +33,9 @@ namespace nv
 		void allocate(uint w, uint h);
 		bool load(const char * name);
 
-		void wrap(void * data, uint w, uint h);
-		void unwrap();
+		/// Use the caller's memory (w * h pixels) instead of allocating, it's never freed or reallocated.
+		NVTT_API void wrap(void * data, uint w, uint h);
+		NVTT_API void unwrap();
 
 		NV_FORCEINLINE uint width() const
 		{
@@ -91,6 +92,7 @@ namespace nv
 		uint m_height;
 		Format m_format;
 		Color32 * m_data;
+		bool m_wrapped;
 	};
 
 